@@ -0,0 +1,73 @@
+/*
+ * Microbenchmark of the conversion kernels in src/kernels.cpp against
+ * the scalar loops they replace (optional<T> per value, as the column
+ * buffers used to hold). Standalone, no R needed; from the package root:
+ *
+ *   g++ -O2 -std=c++17 -Isrc inst/bench/kernels.cpp src/kernels.cpp -o bench-kernels
+ *   ./bench-kernels [rows] [null_every]
+ */
+#include "kernels.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <vector>
+
+static const int32_t NA = std::numeric_limits<int32_t>::min();
+
+template <typename F>
+static double best_of(int reps, F f){
+  double best = 1e300;
+  for(int r = 0; r < reps; r++){
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> d = std::chrono::steady_clock::now() - start;
+    if(d.count() < best){
+      best = d.count();
+    }
+  }
+  return best;
+}
+
+template <typename T>
+static void run(const char* label, size_t n, size_t null_every,
+                void (*kernel)(const T*, size_t, const uint64_t*, size_t, int32_t*, int32_t)){
+  std::vector<std::optional<T>> optionals(n);
+  std::vector<T> values(n);
+  std::vector<uint64_t> valid((n + 63) / 64, ~uint64_t(0));
+  for(size_t i = 0; i < n; i++){
+    T v = static_cast<T>(i % 100);
+    values[i] = v;
+    if(null_every && i % null_every == 0){
+      valid[i / 64] &= ~(uint64_t(1) << (i % 64));
+    }else{
+      optionals[i] = v;
+    }
+  }
+  size_t words = null_every ? valid.size() : 0;
+  std::vector<int32_t> a(n), b(n);
+
+  double scalar = best_of(10, [&](){
+    for(size_t i = 0; i < n; i++){
+      a[i] = optionals[i] ? static_cast<int32_t>(optionals[i].value()) : NA;
+    }
+  });
+  double vectorized = best_of(10, [&](){
+    kernel(values.data(), n, valid.data(), words, b.data(), NA);
+  });
+  if(a != b){
+    std::fprintf(stderr, "%s: results differ\n", label);
+    std::exit(1);
+  }
+  std::printf("%-8s scalar %8.2f ms   kernel %8.2f ms   x%.1f\n", label, scalar, vectorized, scalar / vectorized);
+}
+
+int main(int argc, char** argv){
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+  size_t null_every = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+  std::printf("%zu rows, %s, %s\n", n, null_every ? "with NULLs" : "no NULLs", RHyper::kernel_isa());
+  run<int8_t>("bool", n, null_every, RHyper::widen_int8);
+  run<int16_t>("smallint", n, null_every, RHyper::widen_int16);
+  return 0;
+}
@@ -5,15 +5,189 @@
 
 using namespace Rcpp;
 
+// appender_create
+SEXP appender_create(SEXP conn_, Rcpp::CharacterVector table_, double flush_rows, double flush_bytes, Rcpp::CharacterVector mapped_, Rcpp::CharacterVector expressions_);
+RcppExport SEXP _RHyper_appender_create(SEXP conn_SEXP, SEXP table_SEXP, SEXP flush_rowsSEXP, SEXP flush_bytesSEXP, SEXP mapped_SEXP, SEXP expressions_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type table_(table_SEXP);
+    Rcpp::traits::input_parameter< double >::type flush_rows(flush_rowsSEXP);
+    Rcpp::traits::input_parameter< double >::type flush_bytes(flush_bytesSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type mapped_(mapped_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type expressions_(expressions_SEXP);
+    rcpp_result_gen = Rcpp::wrap(appender_create(conn_, table_, flush_rows, flush_bytes, mapped_, expressions_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// appender_append
+double appender_append(SEXP appender_, Rcpp::List value_);
+RcppExport SEXP _RHyper_appender_append(SEXP appender_SEXP, SEXP value_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type appender_(appender_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type value_(value_SEXP);
+    rcpp_result_gen = Rcpp::wrap(appender_append(appender_, value_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// appender_flush
+void appender_flush(SEXP appender_);
+RcppExport SEXP _RHyper_appender_flush(SEXP appender_SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type appender_(appender_SEXP);
+    appender_flush(appender_);
+    return R_NilValue;
+END_RCPP
+}
+// appender_close
+double appender_close(SEXP appender_);
+RcppExport SEXP _RHyper_appender_close(SEXP appender_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type appender_(appender_SEXP);
+    rcpp_result_gen = Rcpp::wrap(appender_close(appender_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// appender_info
+Rcpp::List appender_info(SEXP appender_);
+RcppExport SEXP _RHyper_appender_info(SEXP appender_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type appender_(appender_SEXP);
+    rcpp_result_gen = Rcpp::wrap(appender_info(appender_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// sql_placeholders
+int sql_placeholders(SEXP sql_);
+RcppExport SEXP _RHyper_sql_placeholders(SEXP sql_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sql_(sql_SEXP);
+    rcpp_result_gen = Rcpp::wrap(sql_placeholders(sql_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// sql_is_query
+bool sql_is_query(SEXP sql_);
+RcppExport SEXP _RHyper_sql_is_query(SEXP sql_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sql_(sql_SEXP);
+    rcpp_result_gen = Rcpp::wrap(sql_is_query(sql_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// sql_replace_placeholders
+Rcpp::CharacterVector sql_replace_placeholders(SEXP sql_, Rcpp::CharacterVector values_);
+RcppExport SEXP _RHyper_sql_replace_placeholders(SEXP sql_SEXP, SEXP values_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sql_(sql_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type values_(values_SEXP);
+    rcpp_result_gen = Rcpp::wrap(sql_replace_placeholders(sql_, values_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// sql_batch_statement
+Rcpp::CharacterVector sql_batch_statement(SEXP sql_, SEXP staging_);
+RcppExport SEXP _RHyper_sql_batch_statement(SEXP sql_SEXP, SEXP staging_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sql_(sql_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type staging_(staging_SEXP);
+    rcpp_result_gen = Rcpp::wrap(sql_batch_statement(sql_, staging_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// create_pending_result
+SEXP create_pending_result(SEXP statement_);
+RcppExport SEXP _RHyper_create_pending_result(SEXP statement_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type statement_(statement_SEXP);
+    rcpp_result_gen = Rcpp::wrap(create_pending_result(statement_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bind_query
+void bind_query(SEXP conn_, SEXP res_, SEXP staging_, Rcpp::List params_, SEXP batch_, bool split_);
+RcppExport SEXP _RHyper_bind_query(SEXP conn_SEXP, SEXP res_SEXP, SEXP staging_SEXP, SEXP params_SEXP, SEXP batch_SEXP, SEXP split_SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type res_(res_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type staging_(staging_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type params_(params_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type batch_(batch_SEXP);
+    Rcpp::traits::input_parameter< bool >::type split_(split_SEXP);
+    bind_query(conn_, res_, staging_, params_, batch_, split_);
+    return R_NilValue;
+END_RCPP
+}
+// bind_batch_statement
+double bind_batch_statement(SEXP conn_, SEXP res_, SEXP staging_, Rcpp::List params_, SEXP batch_);
+RcppExport SEXP _RHyper_bind_batch_statement(SEXP conn_SEXP, SEXP res_SEXP, SEXP staging_SEXP, SEXP params_SEXP, SEXP batch_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type res_(res_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type staging_(staging_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type params_(params_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type batch_(batch_SEXP);
+    rcpp_result_gen = Rcpp::wrap(bind_batch_statement(conn_, res_, staging_, params_, batch_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bind_statements
+double bind_statements(SEXP conn_, SEXP res_, Rcpp::CharacterVector statements_);
+RcppExport SEXP _RHyper_bind_statements(SEXP conn_SEXP, SEXP res_SEXP, SEXP statements_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type res_(res_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type statements_(statements_SEXP);
+    rcpp_result_gen = Rcpp::wrap(bind_statements(conn_, res_, statements_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// result_binding
+Rcpp::List result_binding(SEXP res_);
+RcppExport SEXP _RHyper_result_binding(SEXP res_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type res_(res_SEXP);
+    rcpp_result_gen = Rcpp::wrap(result_binding(res_));
+    return rcpp_result_gen;
+END_RCPP
+}
 // connect
-SEXP connect(Rcpp::Nullable<Rcpp::CharacterVector> database_, Rcpp::Nullable<Rcpp::CharacterVector> aliases_);
-RcppExport SEXP _RHyper_connect(SEXP database_SEXP, SEXP aliases_SEXP) {
+SEXP connect(Rcpp::Nullable<Rcpp::CharacterVector> database_, Rcpp::Nullable<Rcpp::CharacterVector> aliases_, Rcpp::Nullable<Rcpp::CharacterVector> endpoint_, Rcpp::Nullable<Rcpp::CharacterVector> process_params_, Rcpp::Nullable<Rcpp::CharacterVector> connection_params_);
+RcppExport SEXP _RHyper_connect(SEXP database_SEXP, SEXP aliases_SEXP, SEXP endpoint_SEXP, SEXP process_params_SEXP, SEXP connection_params_SEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::CharacterVector> >::type database_(database_SEXP);
     Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::CharacterVector> >::type aliases_(aliases_SEXP);
-    rcpp_result_gen = Rcpp::wrap(connect(database_, aliases_));
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::CharacterVector> >::type endpoint_(endpoint_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::CharacterVector> >::type process_params_(process_params_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::CharacterVector> >::type connection_params_(connection_params_SEXP);
+    rcpp_result_gen = Rcpp::wrap(connect(database_, aliases_, endpoint_, process_params_, connection_params_));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -38,6 +212,110 @@ BEGIN_RCPP
     return R_NilValue;
 END_RCPP
 }
+// attach_database
+void attach_database(SEXP conn_, SEXP path_, SEXP alias_);
+RcppExport SEXP _RHyper_attach_database(SEXP conn_SEXP, SEXP path_SEXP, SEXP alias_SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type path_(path_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type alias_(alias_SEXP);
+    attach_database(conn_, path_, alias_);
+    return R_NilValue;
+END_RCPP
+}
+// detach_database
+void detach_database(SEXP conn_, SEXP name_);
+RcppExport SEXP _RHyper_detach_database(SEXP conn_SEXP, SEXP name_SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type name_(name_SEXP);
+    detach_database(conn_, name_);
+    return R_NilValue;
+END_RCPP
+}
+// list_tables
+Rcpp::CharacterVector list_tables(SEXP conn_);
+RcppExport SEXP _RHyper_list_tables(SEXP conn_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    rcpp_result_gen = Rcpp::wrap(list_tables(conn_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// has_table
+bool has_table(SEXP conn_, Rcpp::CharacterVector table_);
+RcppExport SEXP _RHyper_has_table(SEXP conn_SEXP, SEXP table_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type table_(table_SEXP);
+    rcpp_result_gen = Rcpp::wrap(has_table(conn_, table_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// table_fields
+Rcpp::CharacterVector table_fields(SEXP conn_, Rcpp::CharacterVector table_);
+RcppExport SEXP _RHyper_table_fields(SEXP conn_SEXP, SEXP table_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type table_(table_SEXP);
+    rcpp_result_gen = Rcpp::wrap(table_fields(conn_, table_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// read_table
+Rcpp::List read_table(SEXP conn_, Rcpp::CharacterVector table_, SEXP frame_);
+RcppExport SEXP _RHyper_read_table(SEXP conn_SEXP, SEXP table_SEXP, SEXP frame_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type table_(table_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type frame_(frame_SEXP);
+    rcpp_result_gen = Rcpp::wrap(read_table(conn_, table_, frame_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// set_concurrent_results
+void set_concurrent_results(SEXP conn_, bool enabled_);
+RcppExport SEXP _RHyper_set_concurrent_results(SEXP conn_SEXP, SEXP enabled_SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< bool >::type enabled_(enabled_SEXP);
+    set_concurrent_results(conn_, enabled_);
+    return R_NilValue;
+END_RCPP
+}
+// statement_cache_resize
+void statement_cache_resize(SEXP conn_, double size_);
+RcppExport SEXP _RHyper_statement_cache_resize(SEXP conn_SEXP, SEXP size_SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< double >::type size_(size_SEXP);
+    statement_cache_resize(conn_, size_);
+    return R_NilValue;
+END_RCPP
+}
+// statement_cache_info
+Rcpp::List statement_cache_info(SEXP conn_);
+RcppExport SEXP _RHyper_statement_cache_info(SEXP conn_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    rcpp_result_gen = Rcpp::wrap(statement_cache_info(conn_));
+    return rcpp_result_gen;
+END_RCPP
+}
 // is_valid_connection
 bool is_valid_connection(SEXP conn_);
 RcppExport SEXP _RHyper_is_valid_connection(SEXP conn_SEXP) {
@@ -60,15 +338,193 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// copy_begin
+SEXP copy_begin(SEXP conn_, SEXP statement_, bool csv, bool header);
+RcppExport SEXP _RHyper_copy_begin(SEXP conn_SEXP, SEXP statement_SEXP, SEXP csvSEXP, SEXP headerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type statement_(statement_SEXP);
+    Rcpp::traits::input_parameter< bool >::type csv(csvSEXP);
+    Rcpp::traits::input_parameter< bool >::type header(headerSEXP);
+    rcpp_result_gen = Rcpp::wrap(copy_begin(conn_, statement_, csv, header));
+    return rcpp_result_gen;
+END_RCPP
+}
+// copy_write
+void copy_write(SEXP stream_, Rcpp::RawVector block_);
+RcppExport SEXP _RHyper_copy_write(SEXP stream_SEXP, SEXP block_SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stream_(stream_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::RawVector >::type block_(block_SEXP);
+    copy_write(stream_, block_);
+    return R_NilValue;
+END_RCPP
+}
+// copy_end
+Rcpp::List copy_end(SEXP stream_);
+RcppExport SEXP _RHyper_copy_end(SEXP stream_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stream_(stream_SEXP);
+    rcpp_result_gen = Rcpp::wrap(copy_end(stream_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// copy_abort
+void copy_abort(SEXP stream_);
+RcppExport SEXP _RHyper_copy_abort(SEXP stream_SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stream_(stream_SEXP);
+    copy_abort(stream_);
+    return R_NilValue;
+END_RCPP
+}
+// append_table
+double append_table(SEXP conn_, Rcpp::CharacterVector table_, Rcpp::List value_, Rcpp::CharacterVector mapped_, Rcpp::CharacterVector expressions_);
+RcppExport SEXP _RHyper_append_table(SEXP conn_SEXP, SEXP table_SEXP, SEXP value_SEXP, SEXP mapped_SEXP, SEXP expressions_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type table_(table_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type value_(value_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type mapped_(mapped_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type expressions_(expressions_SEXP);
+    rcpp_result_gen = Rcpp::wrap(append_table(conn_, table_, value_, mapped_, expressions_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_queries
+Rcpp::List get_queries(SEXP conn_, Rcpp::CharacterVector queries_, double threads_, SEXP frame_);
+RcppExport SEXP _RHyper_get_queries(SEXP conn_SEXP, SEXP queries_SEXP, SEXP threads_SEXP, SEXP frame_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type queries_(queries_SEXP);
+    Rcpp::traits::input_parameter< double >::type threads_(threads_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type frame_(frame_SEXP);
+    rcpp_result_gen = Rcpp::wrap(get_queries(conn_, queries_, threads_, frame_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// read_partitions
+Rcpp::List read_partitions(SEXP conn_, Rcpp::CharacterVector queries_, double threads_, SEXP frame_);
+RcppExport SEXP _RHyper_read_partitions(SEXP conn_SEXP, SEXP queries_SEXP, SEXP threads_SEXP, SEXP frame_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type queries_(queries_SEXP);
+    Rcpp::traits::input_parameter< double >::type threads_(threads_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type frame_(frame_SEXP);
+    rcpp_result_gen = Rcpp::wrap(read_partitions(conn_, queries_, threads_, frame_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pool_create
+SEXP pool_create(double min_size, double max_size, double idle_timeout, double checkout_timeout, Rcpp::Nullable<Rcpp::CharacterVector> process_params_, Rcpp::Nullable<Rcpp::CharacterVector> connection_params_);
+RcppExport SEXP _RHyper_pool_create(SEXP min_sizeSEXP, SEXP max_sizeSEXP, SEXP idle_timeoutSEXP, SEXP checkout_timeoutSEXP, SEXP process_params_SEXP, SEXP connection_params_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< double >::type min_size(min_sizeSEXP);
+    Rcpp::traits::input_parameter< double >::type max_size(max_sizeSEXP);
+    Rcpp::traits::input_parameter< double >::type idle_timeout(idle_timeoutSEXP);
+    Rcpp::traits::input_parameter< double >::type checkout_timeout(checkout_timeoutSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::CharacterVector> >::type process_params_(process_params_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<Rcpp::CharacterVector> >::type connection_params_(connection_params_SEXP);
+    rcpp_result_gen = Rcpp::wrap(pool_create(min_size, max_size, idle_timeout, checkout_timeout, process_params_, connection_params_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pool_checkout
+SEXP pool_checkout(SEXP pool_);
+RcppExport SEXP _RHyper_pool_checkout(SEXP pool_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type pool_(pool_SEXP);
+    rcpp_result_gen = Rcpp::wrap(pool_checkout(pool_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pool_return
+void pool_return(SEXP pool_, SEXP conn_);
+RcppExport SEXP _RHyper_pool_return(SEXP pool_SEXP, SEXP conn_SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type pool_(pool_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    pool_return(pool_, conn_);
+    return R_NilValue;
+END_RCPP
+}
+// pool_close
+void pool_close(SEXP pool_);
+RcppExport SEXP _RHyper_pool_close(SEXP pool_SEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type pool_(pool_SEXP);
+    pool_close(pool_);
+    return R_NilValue;
+END_RCPP
+}
+// pool_info
+Rcpp::List pool_info(SEXP pool_);
+RcppExport SEXP _RHyper_pool_info(SEXP pool_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type pool_(pool_SEXP);
+    rcpp_result_gen = Rcpp::wrap(pool_info(pool_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// hyper_process_running
+bool hyper_process_running();
+RcppExport SEXP _RHyper_hyper_process_running() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(hyper_process_running());
+    return rcpp_result_gen;
+END_RCPP
+}
+// hyper_process_leases
+int hyper_process_leases();
+RcppExport SEXP _RHyper_hyper_process_leases() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(hyper_process_leases());
+    return rcpp_result_gen;
+END_RCPP
+}
+// hyper_process_shutdown
+void hyper_process_shutdown();
+RcppExport SEXP _RHyper_hyper_process_shutdown() {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    hyper_process_shutdown();
+    return R_NilValue;
+END_RCPP
+}
 // create_result2
-SEXP create_result2(SEXP conn_, SEXP statement_);
-RcppExport SEXP _RHyper_create_result2(SEXP conn_SEXP, SEXP statement_SEXP) {
+SEXP create_result2(SEXP conn_, SEXP statement_, bool immutable_);
+RcppExport SEXP _RHyper_create_result2(SEXP conn_SEXP, SEXP statement_SEXP, SEXP immutable_SEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
     Rcpp::traits::input_parameter< SEXP >::type statement_(statement_SEXP);
-    rcpp_result_gen = Rcpp::wrap(create_result2(conn_, statement_));
+    Rcpp::traits::input_parameter< bool >::type immutable_(immutable_SEXP);
+    rcpp_result_gen = Rcpp::wrap(create_result2(conn_, statement_, immutable_));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -83,14 +539,15 @@ BEGIN_RCPP
 END_RCPP
 }
 // fetch_rows
-Rcpp::List fetch_rows(SEXP res_, Rcpp::Nullable<int> n_);
-RcppExport SEXP _RHyper_fetch_rows(SEXP res_SEXP, SEXP n_SEXP) {
+Rcpp::List fetch_rows(SEXP res_, SEXP frame_, Rcpp::Nullable<double> n_);
+RcppExport SEXP _RHyper_fetch_rows(SEXP res_SEXP, SEXP frame_SEXP, SEXP n_SEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< SEXP >::type res_(res_SEXP);
-    Rcpp::traits::input_parameter< Rcpp::Nullable<int> >::type n_(n_SEXP);
-    rcpp_result_gen = Rcpp::wrap(fetch_rows(res_, n_));
+    Rcpp::traits::input_parameter< SEXP >::type frame_(frame_SEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<double> >::type n_(n_SEXP);
+    rcpp_result_gen = Rcpp::wrap(fetch_rows(res_, frame_, n_));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -116,20 +573,98 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// result_column_info
+Rcpp::List result_column_info(SEXP res_);
+RcppExport SEXP _RHyper_result_column_info(SEXP res_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type res_(res_SEXP);
+    rcpp_result_gen = Rcpp::wrap(result_column_info(res_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_query
+Rcpp::List get_query(SEXP conn_, SEXP statement_, SEXP frame_, bool immutable_);
+RcppExport SEXP _RHyper_get_query(SEXP conn_SEXP, SEXP statement_SEXP, SEXP frame_SEXP, SEXP immutable_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type statement_(statement_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type frame_(frame_SEXP);
+    Rcpp::traits::input_parameter< bool >::type immutable_(immutable_SEXP);
+    rcpp_result_gen = Rcpp::wrap(get_query(conn_, statement_, frame_, immutable_));
+    return rcpp_result_gen;
+END_RCPP
+}
+// describe_query
+Rcpp::List describe_query(SEXP conn_, SEXP statement_);
+RcppExport SEXP _RHyper_describe_query(SEXP conn_SEXP, SEXP statement_SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type conn_(conn_SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type statement_(statement_SEXP);
+    rcpp_result_gen = Rcpp::wrap(describe_query(conn_, statement_));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 RcppExport SEXP run_testthat_tests();
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_RHyper_connect", (DL_FUNC) &_RHyper_connect, 2},
+    {"_RHyper_appender_create", (DL_FUNC) &_RHyper_appender_create, 6},
+    {"_RHyper_appender_append", (DL_FUNC) &_RHyper_appender_append, 2},
+    {"_RHyper_appender_flush", (DL_FUNC) &_RHyper_appender_flush, 1},
+    {"_RHyper_appender_close", (DL_FUNC) &_RHyper_appender_close, 1},
+    {"_RHyper_appender_info", (DL_FUNC) &_RHyper_appender_info, 1},
+    {"_RHyper_sql_placeholders", (DL_FUNC) &_RHyper_sql_placeholders, 1},
+    {"_RHyper_sql_is_query", (DL_FUNC) &_RHyper_sql_is_query, 1},
+    {"_RHyper_sql_replace_placeholders", (DL_FUNC) &_RHyper_sql_replace_placeholders, 2},
+    {"_RHyper_sql_batch_statement", (DL_FUNC) &_RHyper_sql_batch_statement, 2},
+    {"_RHyper_create_pending_result", (DL_FUNC) &_RHyper_create_pending_result, 1},
+    {"_RHyper_bind_query", (DL_FUNC) &_RHyper_bind_query, 6},
+    {"_RHyper_bind_batch_statement", (DL_FUNC) &_RHyper_bind_batch_statement, 5},
+    {"_RHyper_bind_statements", (DL_FUNC) &_RHyper_bind_statements, 3},
+    {"_RHyper_result_binding", (DL_FUNC) &_RHyper_result_binding, 1},
+    {"_RHyper_connect", (DL_FUNC) &_RHyper_connect, 5},
     {"_RHyper_disconnect", (DL_FUNC) &_RHyper_disconnect, 1},
     {"_RHyper_execute_command", (DL_FUNC) &_RHyper_execute_command, 2},
+    {"_RHyper_attach_database", (DL_FUNC) &_RHyper_attach_database, 3},
+    {"_RHyper_detach_database", (DL_FUNC) &_RHyper_detach_database, 2},
+    {"_RHyper_list_tables", (DL_FUNC) &_RHyper_list_tables, 1},
+    {"_RHyper_has_table", (DL_FUNC) &_RHyper_has_table, 2},
+    {"_RHyper_table_fields", (DL_FUNC) &_RHyper_table_fields, 2},
+    {"_RHyper_read_table", (DL_FUNC) &_RHyper_read_table, 3},
+    {"_RHyper_set_concurrent_results", (DL_FUNC) &_RHyper_set_concurrent_results, 2},
+    {"_RHyper_statement_cache_resize", (DL_FUNC) &_RHyper_statement_cache_resize, 2},
+    {"_RHyper_statement_cache_info", (DL_FUNC) &_RHyper_statement_cache_info, 1},
     {"_RHyper_is_valid_connection", (DL_FUNC) &_RHyper_is_valid_connection, 1},
     {"_RHyper_file_name_impl", (DL_FUNC) &_RHyper_file_name_impl, 1},
-    {"_RHyper_create_result2", (DL_FUNC) &_RHyper_create_result2, 2},
+    {"_RHyper_copy_begin", (DL_FUNC) &_RHyper_copy_begin, 4},
+    {"_RHyper_copy_write", (DL_FUNC) &_RHyper_copy_write, 2},
+    {"_RHyper_copy_end", (DL_FUNC) &_RHyper_copy_end, 1},
+    {"_RHyper_copy_abort", (DL_FUNC) &_RHyper_copy_abort, 1},
+    {"_RHyper_append_table", (DL_FUNC) &_RHyper_append_table, 5},
+    {"_RHyper_get_queries", (DL_FUNC) &_RHyper_get_queries, 4},
+    {"_RHyper_read_partitions", (DL_FUNC) &_RHyper_read_partitions, 4},
+    {"_RHyper_pool_create", (DL_FUNC) &_RHyper_pool_create, 6},
+    {"_RHyper_pool_checkout", (DL_FUNC) &_RHyper_pool_checkout, 1},
+    {"_RHyper_pool_return", (DL_FUNC) &_RHyper_pool_return, 2},
+    {"_RHyper_pool_close", (DL_FUNC) &_RHyper_pool_close, 1},
+    {"_RHyper_pool_info", (DL_FUNC) &_RHyper_pool_info, 1},
+    {"_RHyper_hyper_process_running", (DL_FUNC) &_RHyper_hyper_process_running, 0},
+    {"_RHyper_hyper_process_leases", (DL_FUNC) &_RHyper_hyper_process_leases, 0},
+    {"_RHyper_hyper_process_shutdown", (DL_FUNC) &_RHyper_hyper_process_shutdown, 0},
+    {"_RHyper_create_result2", (DL_FUNC) &_RHyper_create_result2, 3},
     {"_RHyper_clear_result2", (DL_FUNC) &_RHyper_clear_result2, 1},
-    {"_RHyper_fetch_rows", (DL_FUNC) &_RHyper_fetch_rows, 2},
+    {"_RHyper_fetch_rows", (DL_FUNC) &_RHyper_fetch_rows, 3},
     {"_RHyper_has_completed2", (DL_FUNC) &_RHyper_has_completed2, 1},
     {"_RHyper_is_valid_result", (DL_FUNC) &_RHyper_is_valid_result, 1},
+    {"_RHyper_result_column_info", (DL_FUNC) &_RHyper_result_column_info, 1},
+    {"_RHyper_get_query", (DL_FUNC) &_RHyper_get_query, 4},
+    {"_RHyper_describe_query", (DL_FUNC) &_RHyper_describe_query, 2},
     {"run_testthat_tests", (DL_FUNC) &run_testthat_tests, 0},
     {NULL, NULL, 0}
 };
@@ -0,0 +1,108 @@
+#include "hyperapi/hyperapi.hpp"
+#include "connection.h"
+#include "appender.h"
+#include <Rcpp.h>
+
+typedef std::unique_ptr<RHyper::connection> conn_ptr;
+
+namespace RHyper {
+
+bool appender::connection_alive(){
+  return conn->handle() == handle && conn->is_open();
+};
+
+int64_t appender::append(Rcpp::List df){
+
+  if(!is_open){
+    Rcpp::stop("The appender is closed.");
+  }
+  if(!connection_alive()){
+    Rcpp::stop("The appender's connection is closed.");
+  }
+
+  auto names = Rcpp::as<std::vector<std::string>>(df.names());
+  if(columns.empty()){
+    columns = names;
+  }else if(names != columns){
+    Rcpp::stop("All batches must have the same columns, in the same order, as the first one.");
+  }
+
+  if(!ins){
+    ins = conn->create_inserter(table, df, mapped, expressions);
+  }
+
+  int64_t n = ins->append(df);
+  pending += n;
+  total += n;
+
+  if((flush_rows > 0 && pending >= flush_rows) || (flush_bytes > 0 && ins->bytes_written() >= flush_bytes)){
+    flush();
+  }
+
+  return n;
+};
+
+void appender::flush(){
+  if(!ins){ return; }
+  if(!connection_alive()){
+    ins->abandon();
+    ins.reset();
+    pending = 0;
+    Rcpp::stop("The appender's connection is closed; pending rows are lost.");
+  }
+  // Reset first: a failed commit leaves nothing to retry.
+  std::unique_ptr<inserter> i = std::move(ins);
+  pending = 0;
+  i->execute();
+};
+
+int64_t appender::close(){
+  if(is_open){
+    is_open = false;
+    flush();
+  }
+  return total;
+};
+
+}
+
+// [[Rcpp::export]]
+SEXP appender_create(SEXP conn_, Rcpp::CharacterVector table_, double flush_rows, double flush_bytes, Rcpp::CharacterVector mapped_, Rcpp::CharacterVector expressions_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  auto table = RHyper::make_table_name(Rcpp::as<std::vector<std::string>>(table_));
+  auto mapped = Rcpp::as<std::vector<std::string>>(mapped_);
+  auto expressions = Rcpp::as<std::vector<std::string>>(expressions_);
+  appender_ptr* out = new appender_ptr(new RHyper::appender(*conn->get(), table, static_cast<int64_t>(flush_rows), static_cast<int64_t>(flush_bytes), mapped, expressions));
+  // The connection's external pointer is protected by the appender's,
+  // so the connection cannot be finalized first.
+  return Rcpp::XPtr<appender_ptr>(out, true, R_NilValue, conn_);
+}
+
+// [[Rcpp::export]]
+double appender_append(SEXP appender_, Rcpp::List value_){
+  auto app = Rcpp::XPtr<appender_ptr>(appender_);
+  return static_cast<double>(app->get()->append(value_));
+}
+
+// [[Rcpp::export]]
+void appender_flush(SEXP appender_){
+  auto app = Rcpp::XPtr<appender_ptr>(appender_);
+  app->get()->flush();
+}
+
+// [[Rcpp::export]]
+double appender_close(SEXP appender_){
+  auto app = Rcpp::XPtr<appender_ptr>(appender_);
+  return static_cast<double>(app->get()->close());
+}
+
+// [[Rcpp::export]]
+Rcpp::List appender_info(SEXP appender_){
+  auto app = Rcpp::XPtr<appender_ptr>(appender_);
+  auto a = app->get();
+  return Rcpp::List::create(
+    Rcpp::Named("open") = a->check_validity(),
+    Rcpp::Named("rows_pending") = static_cast<double>(a->rows_pending()),
+    Rcpp::Named("rows_appended") = static_cast<double>(a->rows_appended())
+  );
+}
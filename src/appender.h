@@ -0,0 +1,64 @@
+
+#ifndef __RHYPER_APPENDER__
+#define __RHYPER_APPENDER__
+
+#include "hyperapi/hyperapi.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+#include <Rcpp.h>
+#include "inserter.h"
+#include "connection.h"
+
+namespace RHyper {
+
+/*
+ * Keeps one inserter open across many appends, so small batches do not
+ * each pay for the catalog lookup, inserter setup and commit. Rows
+ * become visible when the appender is flushed, either explicitly, on
+ * close, or when one of the row/byte thresholds is crossed. The
+ * connection cannot run other statements while an insert is open.
+ *
+ * The R object keeps the connection object alive (see appender_create),
+ * but its handle may be closed or handed back to a pool meanwhile: the
+ * insert is then abandoned, never closed through a freed handle.
+ */
+class appender {
+private:
+  connection* conn;
+  const hyperapi::Connection* handle;
+  hyperapi::TableName table;
+  std::vector<std::string> columns;
+  std::vector<std::string> mapped;
+  std::vector<std::string> expressions;
+  std::unique_ptr<inserter> ins;
+  int64_t flush_rows;
+  int64_t flush_bytes;
+  int64_t pending = 0;
+  int64_t total = 0;
+  bool is_open = true;
+public:
+  appender(appender const &)=delete;
+  appender &operator=(appender const &)=delete;
+  appender(connection& c, hyperapi::TableName t, int64_t rows, int64_t bytes, std::vector<std::string> m = {}, std::vector<std::string> e = {}):
+    conn(&c), handle(c.handle()), table(std::move(t)), mapped(std::move(m)), expressions(std::move(e)), flush_rows(rows), flush_bytes(bytes) {};
+  int64_t append(Rcpp::List df);
+  void flush();
+  int64_t close();
+  bool check_validity(){ return is_open; };
+  int64_t rows_pending(){ return pending; };
+  int64_t rows_appended(){ return total; };
+  bool connection_alive();
+  // ~inserter() rolls back whatever is pending.
+  ~appender(){
+    if(ins && !connection_alive()){
+      ins->abandon();
+    }
+  };
+};
+
+}
+
+typedef std::unique_ptr<RHyper::appender> appender_ptr;
+
+#endif
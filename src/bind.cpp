@@ -0,0 +1,299 @@
+#include "hyperapi/hyperapi.hpp"
+#include "bind.h"
+#include "connection.h"
+#include <cctype>
+#include <functional>
+#include <Rcpp.h>
+
+typedef std::unique_ptr<RHyper::connection> conn_ptr;
+typedef std::shared_ptr<RHyper::result> result_ptr;
+
+namespace RHyper {
+
+// Skips the string literal, quoted identifier or comment starting at
+// `i`, if any; returns whether it did.
+static bool skip_quoted(const std::string& sql, size_t& i){
+  char ch = sql[i];
+  if(ch == '\'' || ch == '"'){
+    // Doubled quotes inside are handled by leaving and re-entering.
+    size_t close = sql.find(ch, i + 1);
+    i = (close == std::string::npos) ? sql.size() : close + 1;
+  }else if(ch == '-' && i + 1 < sql.size() && sql[i + 1] == '-'){
+    size_t close = sql.find('\n', i);
+    i = (close == std::string::npos) ? sql.size() : close + 1;
+  }else if(ch == '/' && i + 1 < sql.size() && sql[i + 1] == '*'){
+    size_t close = sql.find("*/", i + 2);
+    i = (close == std::string::npos) ? sql.size() : close + 2;
+  }else{
+    return false;
+  }
+  return true;
+};
+
+// Calls `f(begin, end, index)` for each placeholder, where [begin, end)
+// is its span in `sql`.
+static void scan_placeholders(const std::string& sql, const std::function<void(size_t, size_t, int)>& f){
+  size_t i = 0;
+  while(i < sql.size()){
+    char ch = sql[i];
+    if(skip_quoted(sql, i)){
+      continue;
+    }else if(ch == '$' && i + 1 < sql.size() && std::isdigit(static_cast<unsigned char>(sql[i + 1]))){
+      size_t j = i + 1;
+      while(j < sql.size() && std::isdigit(static_cast<unsigned char>(sql[j]))){ j++; }
+      f(i, j, std::stoi(sql.substr(i + 1, j - i - 1)));
+      i = j;
+    }else{
+      i++;
+    }
+  }
+};
+
+int count_placeholders(const std::string& sql){
+  int out = 0;
+  scan_placeholders(sql, [&](size_t, size_t, int k){ out = std::max(out, k); });
+  return out;
+};
+
+std::string replace_placeholders(const std::string& sql, const std::vector<std::string>& values){
+  std::string out;
+  size_t last = 0;
+  scan_placeholders(sql, [&](size_t begin, size_t end, int k){
+    if(k < 1 || static_cast<size_t>(k) > values.size()){
+      throw std::runtime_error("No value for parameter $" + std::to_string(k) + ".");
+    }
+    out.append(sql, last, begin - last);
+    out += values[k - 1];
+    last = end;
+  });
+  out.append(sql, last, std::string::npos);
+  return out;
+};
+
+static bool is_word_char(char ch){
+  return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_';
+};
+
+// Position of `word` (upper case) as a keyword outside of parentheses,
+// quotes and comments, or npos.
+static size_t find_keyword(const std::string& sql, const std::string& word){
+  int depth = 0;
+  size_t i = 0;
+  while(i < sql.size()){
+    if(skip_quoted(sql, i)){
+      continue;
+    }
+    char ch = sql[i];
+    if(ch == '('){
+      depth++;
+    }else if(ch == ')'){
+      depth--;
+    }else if(is_word_char(ch)){
+      size_t j = i;
+      while(j < sql.size() && is_word_char(sql[j])){ j++; }
+      if(depth == 0 && j - i == word.size()){
+        bool same = true;
+        for(size_t k = 0; k < word.size(); k++){
+          same = same && std::toupper(static_cast<unsigned char>(sql[i + k])) == word[k];
+        }
+        if(same){
+          return i;
+        }
+      }
+      i = j;
+      continue;
+    }
+    i++;
+  }
+  return std::string::npos;
+};
+
+// Position just past the parenthesis matching the one at `open`, or npos.
+static size_t past_group(const std::string& sql, size_t open){
+  int depth = 0;
+  size_t i = open;
+  while(i < sql.size()){
+    if(skip_quoted(sql, i)){
+      continue;
+    }
+    if(sql[i] == '('){
+      depth++;
+    }else if(sql[i] == ')' && --depth == 0){
+      return i + 1;
+    }
+    i++;
+  }
+  return std::string::npos;
+};
+
+static std::string trim(const std::string& x){
+  size_t begin = 0;
+  size_t end = x.size();
+  while(begin < end && std::isspace(static_cast<unsigned char>(x[begin]))){ begin++; }
+  while(end > begin && std::isspace(static_cast<unsigned char>(x[end - 1]))){ end--; }
+  return x.substr(begin, end - begin);
+};
+
+// `INSERT ... VALUES (row)` becomes `INSERT ... SELECT row FROM staging`
+// and `DELETE ... WHERE condition` keeps the rows for which the
+// condition holds for any parameter row. Both affect the same rows as
+// running the statement once per row; anything else (UPDATE, several
+// VALUES rows, DEFAULT, RETURNING, ...) is left to the per-row path.
+std::string batch_statement(const std::string& sql, const std::string& staging){
+  std::vector<std::string> params;
+  for(int k = 1; k <= count_placeholders(sql); k++){
+    params.push_back("rhyper_params.rhyper_p" + std::to_string(k));
+  }
+  std::string from = " FROM " + staging + " AS rhyper_params";
+  std::string keyword = first_keyword(sql);
+  std::string body = strip_terminator(sql);
+
+  if(keyword == "INSERT"){
+    size_t values = find_keyword(body, "VALUES");
+    if(values == std::string::npos){
+      return "";
+    }
+    std::string head = body.substr(0, values);
+    std::string tail = trim(body.substr(values + 6));
+    if(count_placeholders(head) > 0 || tail.empty() || tail[0] != '(' || past_group(tail, 0) != tail.size()){
+      return "";
+    }
+    std::string row = tail.substr(1, tail.size() - 2);
+    if(find_keyword(row, "DEFAULT") != std::string::npos){
+      return "";
+    }
+    return head + "SELECT " + replace_placeholders(row, params) + from + " ORDER BY rhyper_params.rhyper_row";
+  }
+  if(keyword == "DELETE"){
+    size_t where = find_keyword(body, "WHERE");
+    if(where == std::string::npos){
+      return "";
+    }
+    std::string head = body.substr(0, where);
+    std::string condition = trim(body.substr(where + 5));
+    if(count_placeholders(head) > 0 || find_keyword(condition, "RETURNING") != std::string::npos){
+      return "";
+    }
+    return head + "WHERE EXISTS (SELECT 1" + from + " WHERE " + replace_placeholders(condition, params) + ")";
+  }
+  return "";
+};
+
+// Statements that return rows and can be used as a subquery.
+bool is_query(const std::string& sql){
+  std::string keyword = first_keyword(sql);
+  return keyword == "SELECT" || keyword == "WITH" || keyword == "VALUES" || keyword == "TABLE";
+};
+
+}
+
+// [[Rcpp::export]]
+int sql_placeholders(SEXP sql_){
+  return RHyper::count_placeholders(Rcpp::as<std::string>(sql_));
+}
+
+// [[Rcpp::export]]
+bool sql_is_query(SEXP sql_){
+  return RHyper::is_query(Rcpp::as<std::string>(sql_));
+}
+
+// [[Rcpp::export]]
+Rcpp::CharacterVector sql_replace_placeholders(SEXP sql_, Rcpp::CharacterVector values_){
+  auto values = Rcpp::as<std::vector<std::string>>(values_);
+  return Rcpp::wrap(RHyper::replace_placeholders(Rcpp::as<std::string>(sql_), values));
+}
+
+// [[Rcpp::export]]
+Rcpp::CharacterVector sql_batch_statement(SEXP sql_, SEXP staging_){
+  return Rcpp::wrap(RHyper::batch_statement(Rcpp::as<std::string>(sql_), Rcpp::as<std::string>(staging_)));
+}
+
+// [[Rcpp::export]]
+SEXP create_pending_result(SEXP statement_){
+  result_ptr* out = new result_ptr(new RHyper::result(Rcpp::as<std::string>(statement_)));
+  return Rcpp::XPtr<result_ptr>(out, true);
+}
+
+// Loads the parameter rows (row id column first) into a temporary
+// table through the binary inserter.
+static int64_t load_staging(RHyper::connection& conn, const std::string& staging, Rcpp::List params){
+  hyperapi::TableName name(staging);
+  auto columns = Rcpp::as<std::vector<std::string>>(params.names());
+  hyperapi::TableDefinition def(name, hyperapi::Persistence::Temporary);
+  for(size_t j = 0; j < columns.size(); j++){
+    def.addColumn(hyperapi::TableDefinition::Column(columns[j], RHyper::infer_sql_type(params[j])));
+  }
+  conn.create_table(def, true);
+
+  auto ins = conn.create_inserter(name, params);
+  int64_t rows = ins->append(params);
+  ins->execute();
+  return rows;
+}
+
+// Runs the batch query over the staged parameter rows and moves its
+// rowset into the pending result, so the R object stays the same.
+// [[Rcpp::export]]
+void bind_query(SEXP conn_, SEXP res_, SEXP staging_, Rcpp::List params_, SEXP batch_, bool split_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  auto res = Rcpp::XPtr<result_ptr>(res_).get();
+  std::string staging = Rcpp::as<std::string>(staging_);
+
+  // Rows of an earlier binding are dropped without a warning.
+  res->get()->close();
+
+  int64_t rows = load_staging(*conn->get(), staging, params_);
+
+  result_ptr batch = conn->get()->execute_query(Rcpp::as<std::string>(batch_));
+  res->get()->take_rowset(*batch);
+  res->get()->set_binding(rows, split_, staging);
+  conn->get()->set_current_result(*res);
+}
+
+// Runs a statement from batch_statement() once over the staged
+// parameter rows, and drops them again.
+// [[Rcpp::export]]
+double bind_batch_statement(SEXP conn_, SEXP res_, SEXP staging_, Rcpp::List params_, SEXP batch_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  auto res = Rcpp::XPtr<result_ptr>(res_).get();
+  std::string staging = Rcpp::as<std::string>(staging_);
+  std::string drop = "DROP TABLE IF EXISTS " + hyperapi::TableName(staging).toString();
+  res->get()->close();
+
+  load_staging(*conn->get(), staging, params_);
+  int64_t affected;
+  try{
+    affected = conn->get()->execute_command(Rcpp::as<std::string>(batch_));
+  }catch(...){
+    conn->get()->execute_command(drop);
+    throw;
+  }
+  conn->get()->execute_command(drop);
+  res->get()->set_rows_affected(affected);
+  return static_cast<double>(affected);
+}
+
+// Executes one statement per parameter row, all in one transaction, and
+// records the total number of rows affected on the result.
+// [[Rcpp::export]]
+double bind_statements(SEXP conn_, SEXP res_, Rcpp::CharacterVector statements_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  auto res = Rcpp::XPtr<result_ptr>(res_).get();
+  auto statements = Rcpp::as<std::vector<std::string>>(statements_);
+  res->get()->close();
+  int64_t affected = conn->get()->execute_batch(statements);
+  res->get()->set_rows_affected(affected);
+  return static_cast<double>(affected);
+}
+
+// [[Rcpp::export]]
+Rcpp::List result_binding(SEXP res_){
+  auto res = Rcpp::XPtr<result_ptr>(res_).get();
+  return Rcpp::List::create(
+    Rcpp::Named("pending") = res->get()->is_pending(),
+    Rcpp::Named("rows") = static_cast<double>(res->get()->get_bound_rows()),
+    Rcpp::Named("split") = res->get()->get_split(),
+    Rcpp::Named("staging") = res->get()->get_staging(),
+    Rcpp::Named("rows_affected") = static_cast<double>(res->get()->get_rows_affected())
+  );
+}
@@ -0,0 +1,24 @@
+
+#ifndef __RHYPER_BIND__
+#define __RHYPER_BIND__
+
+#include <string>
+#include <vector>
+
+namespace RHyper {
+
+/*
+ * Positional parameters ($1, $2, ...) outside of string literals,
+ * quoted identifiers and comments.
+ */
+int count_placeholders(const std::string& sql);
+std::string replace_placeholders(const std::string& sql, const std::vector<std::string>& values);
+bool is_query(const std::string& sql);
+// The statement run once over all parameter rows in `staging` (aliased
+// rhyper_params, with columns rhyper_p1, rhyper_p2, ...), or "" when it
+// has to run once per row.
+std::string batch_statement(const std::string& sql, const std::string& staging);
+
+}
+
+#endif
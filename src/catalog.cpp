@@ -0,0 +1,54 @@
+#include "hyperapi/hyperapi.hpp"
+#include "catalog.h"
+
+namespace RHyper {
+
+std::shared_ptr<const decode_plan> make_decode_plan(const hyperapi::ResultSchema& schema){
+  auto out = std::make_shared<decode_plan>();
+  for(const auto& col: schema.getColumns()){
+    out->names.push_back(col.getName().getUnescaped());
+    out->types.push_back(col.getType());
+  }
+  return out;
+};
+
+std::shared_ptr<const decode_plan> make_decode_plan(const hyperapi::TableDefinition& table){
+  auto out = std::make_shared<decode_plan>();
+  for(const auto& col: table.getColumns()){
+    out->names.push_back(col.getName().getUnescaped());
+    out->types.push_back(col.getType());
+    out->nullable.push_back(col.getNullability() == hyperapi::Nullability::Nullable);
+  }
+  return out;
+};
+
+bool decode_plan::matches(const hyperapi::ResultSchema& schema) const {
+  if(schema.getColumnCount() != types.size()){
+    return false;
+  }
+  for(size_t j = 0; j < types.size(); j++){
+    const auto& col = schema.getColumn(j);
+    if(!(col.getType() == types[j]) || col.getName().getUnescaped() != names[j]){
+      return false;
+    }
+  }
+  return true;
+};
+
+std::vector<hyperapi::TableName> catalog_tables(hyperapi::Connection& c, const std::vector<std::string>& databases){
+  hyperapi::Catalog& catalog = c.getCatalog();
+  std::vector<hyperapi::TableName> out;
+  for(const auto& db: databases){
+    for(const auto& schema: catalog.getSchemaNames(hyperapi::DatabaseName(db))){
+      for(const auto& table: catalog.getTableNames(schema)){
+        out.push_back(table);
+      }
+    }
+  }
+  for(const auto& table: catalog.getTableNames(hyperapi::SchemaName("pg_temp"))){
+    out.push_back(table);
+  }
+  return out;
+};
+
+}
@@ -0,0 +1,76 @@
+
+#ifndef __RHYPER_CATALOG__
+#define __RHYPER_CATALOG__
+
+#include "hyperapi/hyperapi.hpp"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace RHyper {
+
+/*
+ * Column names and types of a query result, as reported by the server.
+ * Types of a result carry no nullability; `nullable` is only filled in
+ * when the result is known to be a whole table, from its definition.
+ * Empty means every column may hold NULLs.
+ */
+struct decode_plan {
+  std::vector<std::string> names;
+  std::vector<hyperapi::SqlType> types;
+  std::vector<bool> nullable;
+  bool is_nullable(size_t j) const { return nullable.empty() || nullable[j]; };
+  bool matches(const hyperapi::ResultSchema& schema) const;
+};
+
+std::shared_ptr<const decode_plan> make_decode_plan(const hyperapi::ResultSchema& schema);
+// For `SELECT * FROM` the table.
+std::shared_ptr<const decode_plan> make_decode_plan(const hyperapi::TableDefinition& table);
+
+// Tables of all attached databases, plus this session's temporary ones.
+std::vector<hyperapi::TableName> catalog_tables(hyperapi::Connection& c, const std::vector<std::string>& databases);
+
+/*
+ * Catalog lookups made on one connection, so that repeated metadata
+ * calls (dbplyr makes many) cost a hash lookup. The connection clears
+ * it on its own DDL and on attach/detach; changes made through other
+ * connections are not seen until then.
+ */
+class metadata_cache {
+private:
+  bool listed = false;
+  std::vector<hyperapi::TableName> tables;
+  std::unordered_map<std::string, bool> exists;
+  std::unordered_map<std::string, std::shared_ptr<const hyperapi::TableDefinition>> definitions;
+public:
+  bool has_tables(){ return listed; };
+  const std::vector<hyperapi::TableName>& get_tables(){ return tables; };
+  void set_tables(std::vector<hyperapi::TableName> t){
+    tables = std::move(t);
+    listed = true;
+  };
+  // nullptr when not cached.
+  const bool* find_exists(const hyperapi::TableName& name){
+    auto hit = exists.find(name.toString());
+    return hit == exists.end() ? nullptr : &hit->second;
+  };
+  void set_exists(const hyperapi::TableName& name, bool value){ exists[name.toString()] = value; };
+  std::shared_ptr<const hyperapi::TableDefinition> find_definition(const hyperapi::TableName& name){
+    auto hit = definitions.find(name.toString());
+    return hit == definitions.end() ? nullptr : hit->second;
+  };
+  void set_definition(const hyperapi::TableName& name, std::shared_ptr<const hyperapi::TableDefinition> def){
+    definitions[name.toString()] = std::move(def);
+  };
+  void invalidate(){
+    listed = false;
+    tables.clear();
+    exists.clear();
+    definitions.clear();
+  };
+};
+
+}
+
+#endif
@@ -4,42 +4,13 @@
 
 #include "hyperapi/hyperapi.hpp"
 #include <vector>
-#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
 #include <Rcpp.h>
-
-inline time_t toUTC(std::tm& timeinfo)
-{
-#ifdef _WIN32
-  std::time_t tt = _mkgmtime(&timeinfo);
-#else
-  time_t tt = timegm(&timeinfo);
-#endif
-  return tt;
-}
-
-inline double get_seconds_since_epoch(
-    int year,
-    int month,
-    int day,
-    int hour,
-    int minute,
-    int second
-) // these are UTC values
-{
-  tm timeinfo1 = tm();
-  timeinfo1.tm_year = year - 1900;
-  timeinfo1.tm_mon = month - 1;
-  timeinfo1.tm_mday = day;
-  timeinfo1.tm_hour = hour;
-  timeinfo1.tm_min = minute;
-  timeinfo1.tm_sec = second;
-  tm timeinfo = timeinfo1;
-  time_t tt = toUTC(timeinfo);
-  std::chrono::system_clock::time_point tp = std::chrono::system_clock::from_time_t(tt);
-  auto seconds_since_epoch = std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count();
-  return seconds_since_epoch;
-};
-
+#include "epoch.h"
+#include "kernels.h"
 
 namespace RHyper {
 
@@ -57,9 +28,73 @@ namespace RHyper {
 //   hyperapi::optional<hyperapi::Timestamp>
 // > hyper_data;
 
+/*
+ * Which values of a column are present: one bit per value, set when
+ * the value is not NULL. Nothing is allocated until the first NULL
+ * arrives, so a column without NULLs (in particular a NOT NULL one)
+ * carries no bitmap at all.
+ */
+class validity_bitmap {
+private:
+  std::vector<uint64_t> words;
+public:
+  bool has_nulls() const { return !words.empty(); };
+  void set_null(size_t i){
+    size_t w = i >> 6;
+    if(words.size() <= w){
+      words.resize(w + 1, ~uint64_t(0));
+    }
+    words[w] &= ~(uint64_t(1) << (i & 63));
+  };
+  bool is_valid(size_t i) const {
+    size_t w = i >> 6;
+    return w >= words.size() || ((words[w] >> (i & 63)) & 1);
+  };
+  const uint64_t* word_data() const { return words.data(); };
+  size_t word_count() const { return words.size(); };
+};
+
+// Gives `x` compact row names for `n` rows. Row names, and with them
+// data.frames, are limited to 2^31 - 1 rows: past that, `x` is left
+// alone and the result is false.
+inline bool set_row_names(Rcpp::List& x, R_xlen_t n){
+  if(n > R_LEN_T_MAX){
+    return false;
+  }
+  x.attr("row.names") = Rcpp::IntegerVector::create(NA_INTEGER, -static_cast<int>(n));
+  return true;
+}
+
+// Data pointer of an atomic vector fill() can write to off the R thread.
+inline void* vector_data(SEXP x){
+  switch(TYPEOF(x)){
+  case LGLSXP:
+    return LOGICAL(x);
+  case INTSXP:
+    return INTEGER(x);
+  case REALSXP:
+    return REAL(x);
+  default:
+    return nullptr;
+  }
+}
+
+/*
+ * Columns keep plain values plus a validity_bitmap. A column known to
+ * be NOT NULL (see decode_plan) is built with nullable = false and
+ * decodes without testing for NULLs; any other column tests each value.
+ * Values are read straight from the rowset's binary representation
+ * (hyperapi::Value befriends base_column for this).
+ */
 class base_column {
+protected:
+  bool nullable = true;
+  validity_bitmap valid;
+  static const uint8_t* raw(const hyperapi::Value& v){ return v.value.value; };
+  static size_t raw_size(const hyperapi::Value& v){ return v.value.size; };
 public:
   base_column(){};
+  explicit base_column(bool is_nullable): nullable(is_nullable) {};
   base_column(base_column const &)=delete;
   base_column &operator=(base_column const &)=delete;
   base_column(base_column &&o){};
@@ -70,169 +105,402 @@ public:
     }
     return *this;
   };
+  virtual ~base_column(){};
   virtual void ingest(const hyperapi::Value& v){  Rcpp::stop("Value is of unsupported type"); };
-  virtual Rcpp::RObject to_sexp(){ Rcpp::stop("Unsupported type"); };
+  virtual Rcpp::RObject to_sexp(){
+    Rcpp::RObject out = allocate(static_cast<R_xlen_t>(size()));
+    fill(out, needs_r_thread() ? nullptr : vector_data(out), 0);
+    return out;
+  };
+  /*
+   * For assembling one R vector from several columns (e.g. partitions
+   * read in parallel): allocate() creates the target on the R thread,
+   * then fill() copies this column's values to target[offset, ...).
+   * fill() writes through `data` (the target's data pointer, taken on
+   * the R thread) and may run on any thread, unless needs_r_thread().
+   */
+  virtual size_t size(){ return 0; };
+  virtual Rcpp::RObject allocate(R_xlen_t n){ Rcpp::stop("Unsupported type"); };
+  virtual void fill(SEXP target, void* data, R_xlen_t offset){ throw std::runtime_error("Unsupported type"); };
+  virtual bool needs_r_thread(){ return false; };
+  bool is_nullable(){ return nullable; };
+  bool has_nulls(){ return valid.has_nulls(); };
 };
 
 class integer_column: public base_column {
 private:
-  int growth_factor = 1;
-  std::vector<hyperapi::optional<int>> data;
+  std::vector<int32_t> data;
 public:
+  using base_column::base_column;
   void ingest(const hyperapi::Value& v){
-    if(data.size() == data.capacity()){
-      growth_factor++;
-      data.reserve(data.size() * growth_factor);
+    const uint8_t* p = raw(v);
+    if(nullable && !p){
+      valid.set_null(data.size());
+      data.push_back(NA_INTEGER);
+      return;
     }
-    data.push_back(v.get<hyperapi::optional<int>>());
+    data.push_back(hyper_read_int32(p));
   };
-  Rcpp::RObject to_sexp(){
-    Rcpp::IntegerVector out = Rcpp::no_init(data.size());
-    for(int i = 0; i < data.size(); i++){
-      if(data[i]){
-        out[i] = data[i].value();
-      }else{
-        out[i] = NA_INTEGER;
-      }
+  size_t size(){ return data.size(); };
+  Rcpp::RObject allocate(R_xlen_t n){ return Rcpp::IntegerVector(Rcpp::no_init(n)); };
+  void fill(SEXP target, void* out, R_xlen_t offset){
+    // NULLs are stored as NA_INTEGER already.
+    std::copy(data.begin(), data.end(), static_cast<int*>(out) + offset);
+  };
+};
+
+class smallint_column: public base_column {
+private:
+  std::vector<int16_t> data;
+public:
+  using base_column::base_column;
+  void ingest(const hyperapi::Value& v){
+    const uint8_t* p = raw(v);
+    if(nullable && !p){
+      valid.set_null(data.size());
+      data.push_back(0);
+      return;
     }
-    return out;
+    data.push_back(hyper_read_int16(p));
+  };
+  size_t size(){ return data.size(); };
+  Rcpp::RObject allocate(R_xlen_t n){ return Rcpp::IntegerVector(Rcpp::no_init(n)); };
+  void fill(SEXP target, void* out, R_xlen_t offset){
+    widen_int16(data.data(), data.size(), valid.word_data(), valid.word_count(), static_cast<int*>(out) + offset, NA_INTEGER);
   };
 };
 
 class double_column: public base_column {
 private:
-  int growth_factor = 1;
-  std::vector<hyperapi::optional<double>> data;
+  std::vector<double> data;
 public:
+  using base_column::base_column;
   void ingest(const hyperapi::Value& v){
-    if(data.size() == data.capacity()){
-      growth_factor++;
-      data.reserve(data.size() * growth_factor);
+    if(nullable && !raw(v)){
+      valid.set_null(data.size());
+      data.push_back(NA_REAL);
+      return;
     }
-    data.push_back(v.get<hyperapi::optional<double>>());
+    // BIGINT and NUMERIC are converted by the Hyper API.
+    data.push_back(v.get<double>());
   };
-  Rcpp::RObject to_sexp(){
-    Rcpp::DoubleVector out = Rcpp::no_init(data.size());
-    for(int i = 0; i < data.size(); i++){
-      if(data[i]){
-        out[i] = data[i].value();
-      }else{
-        out[i] = NA_REAL;
-      }
+  size_t size(){ return data.size(); };
+  Rcpp::RObject allocate(R_xlen_t n){ return Rcpp::DoubleVector(Rcpp::no_init(n)); };
+  void fill(SEXP target, void* out, R_xlen_t offset){
+    // NULLs are stored as NA_REAL already.
+    std::copy(data.begin(), data.end(), static_cast<double*>(out) + offset);
+  };
+};
+
+// OIDs are unsigned 32-bit, beyond the range of R integers.
+class oid_column: public base_column {
+private:
+  std::vector<double> data;
+public:
+  using base_column::base_column;
+  void ingest(const hyperapi::Value& v){
+    const uint8_t* p = raw(v);
+    if(nullable && !p){
+      valid.set_null(data.size());
+      data.push_back(NA_REAL);
+      return;
     }
-    return out;
+    data.push_back(static_cast<double>(static_cast<uint32_t>(hyper_read_int32(p))));
+  };
+  size_t size(){ return data.size(); };
+  Rcpp::RObject allocate(R_xlen_t n){ return Rcpp::DoubleVector(Rcpp::no_init(n)); };
+  void fill(SEXP target, void* out, R_xlen_t offset){
+    std::copy(data.begin(), data.end(), static_cast<double*>(out) + offset);
   };
 };
 
 class bool_column: public base_column {
 private:
-  int growth_factor = 1;
-  std::vector<hyperapi::optional<bool>> data;
+  std::vector<int8_t> data;
 public:
+  using base_column::base_column;
   void ingest(const hyperapi::Value& v){
-    if(data.size() == data.capacity()){
-      growth_factor++;
-      data.reserve(data.size() * growth_factor);
+    const uint8_t* p = raw(v);
+    if(nullable && !p){
+      valid.set_null(data.size());
+      data.push_back(0);
+      return;
     }
-    data.push_back(v.get<hyperapi::optional<bool>>());
+    data.push_back(hyper_read_int8(p));
   };
-  Rcpp::RObject to_sexp(){
-    Rcpp::LogicalVector out = Rcpp::no_init(data.size());
-    for(int i = 0; i < data.size(); i++){
-      if(data[i]){
-        out[i] = data[i].value();
-      }else{
-        out[i] = NA_LOGICAL;
-      }
-    }
-    return out;
+  size_t size(){ return data.size(); };
+  Rcpp::RObject allocate(R_xlen_t n){ return Rcpp::LogicalVector(Rcpp::no_init(n)); };
+  void fill(SEXP target, void* out, R_xlen_t offset){
+    widen_int8(data.data(), data.size(), valid.word_data(), valid.word_count(), static_cast<int*>(out) + offset, NA_LOGICAL);
   };
 };
 
+/*
+ * Strings from Hyper are UTF-8. CHARSXPs are made with CE_UTF8, so R
+ * marks each one as UTF-8 or ASCII and never translates them again
+ * (Rcpp::wrap() and assignment from std::string would mark them native).
+ */
+inline SEXP utf8_string(const char* p, size_t n){
+  return Rf_mkCharLenCE(p, static_cast<int>(n), CE_UTF8);
+}
+
+inline Rcpp::CharacterVector utf8_strings(const std::vector<std::string>& x){
+  Rcpp::CharacterVector out(x.size());
+  for(size_t i = 0; i < x.size(); i++){
+    SET_STRING_ELT(out, i, utf8_string(x[i].data(), x[i].size()));
+  }
+  return out;
+}
+
+// The strings are kept back to back in one buffer: string i is
+// bytes[ends[i - 1], ends[i]), with ends[-1] = 0. NULLs are empty.
 class string_column: public base_column {
 private:
-  int growth_factor = 1;
-  std::vector<hyperapi::optional<std::string>> data;
+  std::vector<char> bytes;
+  std::vector<size_t> ends;
 public:
+  using base_column::base_column;
   void ingest(const hyperapi::Value& v){
-    if(data.size() == data.capacity()){
-      growth_factor++;
-      data.reserve(data.size() * growth_factor);
+    const uint8_t* p = raw(v);
+    if(nullable && !p){
+      valid.set_null(ends.size());
+      ends.push_back(bytes.size());
+      return;
     }
-    data.push_back(v.get<hyperapi::optional<std::string>>());
+    bytes.insert(bytes.end(), reinterpret_cast<const char*>(p), reinterpret_cast<const char*>(p) + raw_size(v));
+    ends.push_back(bytes.size());
   };
-  Rcpp::RObject to_sexp(){
-    Rcpp::CharacterVector out = Rcpp::no_init(data.size());
-    for(int i = 0; i < data.size(); i++){
-      if(data[i]){
-        out[i] = data[i].value();
+  size_t size(){ return ends.size(); };
+  Rcpp::RObject allocate(R_xlen_t n){ return Rcpp::CharacterVector(n); };
+  // CHARSXPs can only be created on the R thread.
+  bool needs_r_thread(){ return true; };
+  void fill(SEXP target, void* out, R_xlen_t offset){
+    R_xlen_t n = static_cast<R_xlen_t>(ends.size());
+    size_t begin = 0;
+    for(R_xlen_t i = 0; i < n; i++){
+      if(valid.is_valid(i)){
+        SET_STRING_ELT(target, offset + i, utf8_string(bytes.data() + begin, ends[i] - begin));
       }else{
-        out[i] = NA_STRING;
+        SET_STRING_ELT(target, offset + i, NA_STRING);
       }
+      begin = ends[i];
     }
-    return out;
   };
 };
 
-class date_column: public base_column {
+/*
+ * A blob::blob(): a list of raw vectors, NULL for NULL. Used for BYTEA
+ * and GEOGRAPHY (in Hyper's own binary encoding).
+ *
+ * When decoding on the R thread (`direct`), each value is copied once,
+ * straight from the rowset into a raw vector of its exact size; the raw
+ * vectors are kept in `values` until the column is assembled. Off the R
+ * thread no R objects can be made, so values are kept back to back
+ * like those of string_column and copied into raw vectors by fill().
+ */
+class bytes_column: public base_column {
 private:
-  int growth_factor = 1;
-  std::vector<hyperapi::optional<hyperapi::Date>> data;
+  bool direct = false;
+  Rcpp::List values;
+  R_xlen_t count = 0;
+  std::vector<uint8_t> bytes;
+  std::vector<size_t> ends;
+  void keep(SEXP value){
+    if(count == values.size()){
+      Rcpp::List grown(std::max<R_xlen_t>(1024, 2 * count));
+      for(R_xlen_t i = 0; i < count; i++){
+        SET_VECTOR_ELT(grown, i, VECTOR_ELT(values, i));
+      }
+      values = grown;
+    }
+    SET_VECTOR_ELT(values, count++, value);
+  };
 public:
+  bytes_column(bool is_nullable, bool on_r_thread): base_column(is_nullable), direct(on_r_thread) {};
   void ingest(const hyperapi::Value& v){
-    if(data.size() == data.capacity()){
-      growth_factor++;
-      data.reserve(data.size() * growth_factor);
+    const uint8_t* p = raw(v);
+    if(direct){
+      if(nullable && !p){
+        valid.set_null(count);
+        keep(R_NilValue);
+        return;
+      }
+      size_t n = raw_size(v);
+      SEXP value = PROTECT(Rf_allocVector(RAWSXP, static_cast<R_xlen_t>(n)));
+      if(n > 0){
+        std::memcpy(RAW(value), p, n);
+      }
+      keep(value);
+      UNPROTECT(1);
+      return;
     }
-    data.push_back(v.get<hyperapi::optional<hyperapi::Date>>());
-  };
-  Rcpp::RObject to_sexp(){
-    Rcpp::DateVector out(data.size());
-    for(int i = 0; i < data.size(); i++){
-      if(data[i]){
-        auto d = data[i].value();
-        out[i] = Rcpp::Date(d.getYear(), d.getMonth(), d.getDay());
-      }else{
-        out[i] = NA_REAL;
+    if(nullable && !p){
+      valid.set_null(ends.size());
+      ends.push_back(bytes.size());
+      return;
+    }
+    bytes.insert(bytes.end(), p, p + raw_size(v));
+    ends.push_back(bytes.size());
+  };
+  size_t size(){ return direct ? static_cast<size_t>(count) : ends.size(); };
+  Rcpp::RObject allocate(R_xlen_t n){
+    Rcpp::List out(n);
+    out.attr("ptype") = Rcpp::RawVector(0);
+    out.attr("class") = Rcpp::CharacterVector::create("blob", "vctrs_list_of", "vctrs_vctr", "list");
+    return out;
+  };
+  bool needs_r_thread(){ return true; };
+  void fill(SEXP target, void* out, R_xlen_t offset){
+    if(direct){
+      for(R_xlen_t i = 0; i < count; i++){
+        SET_VECTOR_ELT(target, offset + i, VECTOR_ELT(values, i));
+      }
+      return;
+    }
+    R_xlen_t n = static_cast<R_xlen_t>(ends.size());
+    size_t begin = 0;
+    for(R_xlen_t i = 0; i < n; i++){
+      if(valid.is_valid(i)){
+        SEXP value = PROTECT(Rf_allocVector(RAWSXP, static_cast<R_xlen_t>(ends[i] - begin)));
+        if(ends[i] > begin){
+          std::memcpy(RAW(value), bytes.data() + begin, ends[i] - begin);
+        }
+        SET_VECTOR_ELT(target, offset + i, value);
+        UNPROTECT(1);
       }
+      begin = ends[i];
     }
+  };
+};
+
+// Days since 1970-01-01.
+class date_column: public base_column {
+private:
+  std::vector<double> data;
+public:
+  using base_column::base_column;
+  void ingest(const hyperapi::Value& v){
+    const uint8_t* p = raw(v);
+    if(nullable && !p){
+      valid.set_null(data.size());
+      data.push_back(NA_REAL);
+      return;
+    }
+    data.push_back(static_cast<double>(hyper_read_int32(p) - unix_epoch_day()));
+  };
+  size_t size(){ return data.size(); };
+  Rcpp::RObject allocate(R_xlen_t n){
+    Rcpp::DoubleVector out = Rcpp::no_init(n);
+    out.attr("class") = "Date";
     return out;
   };
+  void fill(SEXP target, void* out, R_xlen_t offset){
+    std::copy(data.begin(), data.end(), static_cast<double*>(out) + offset);
+  };
 };
 
+// Seconds since 1970-01-01 00:00:00 UTC, with microseconds.
 class timestamp_column: public base_column {
 private:
-  int growth_factor = 1;
-  std::vector<hyperapi::optional<hyperapi::Timestamp>> data;
+  std::vector<double> data;
 public:
+  using base_column::base_column;
   void ingest(const hyperapi::Value& v){
-    if(data.size() == data.capacity()){
-      growth_factor++;
-      data.reserve(data.size() * growth_factor);
+    const uint8_t* p = raw(v);
+    if(nullable && !p){
+      valid.set_null(data.size());
+      data.push_back(NA_REAL);
+      return;
     }
-    data.push_back(v.get<hyperapi::optional<hyperapi::Timestamp>>());
-  };
-  Rcpp::RObject to_sexp(){
-    Rcpp::DatetimeVector out(data.size());
-    for(int i = 0; i < data.size(); i++){
-      if(data[i]){
-        auto dt = data[i].value();
-        auto seconds_since_epoch = get_seconds_since_epoch(
-          dt.getDate().getYear(),
-          dt.getDate().getMonth(),
-          dt.getDate().getDay(),
-          dt.getTime().getHour(),
-          dt.getTime().getMinute(),
-          dt.getTime().getSecond()
-        );
-        out[i] = Rcpp::Datetime(seconds_since_epoch);
-        // out[i] = Rcpp::Datetime(dt.toString());
-      }else{
-        out[i] = NA_REAL;
-      }
+    data.push_back(static_cast<double>(hyper_read_int64(p) - unix_epoch_microseconds()) / MICROSECONDS_PER_SECOND);
+  };
+  size_t size(){ return data.size(); };
+  Rcpp::RObject allocate(R_xlen_t n){
+    Rcpp::DoubleVector out = Rcpp::no_init(n);
+    out.attr("class") = Rcpp::CharacterVector::create("POSIXct", "POSIXt");
+    return out;
+  };
+  void fill(SEXP target, void* out, R_xlen_t offset){
+    std::copy(data.begin(), data.end(), static_cast<double*>(out) + offset);
+  };
+};
+
+// Seconds since midnight, as an hms::hms().
+class time_column: public base_column {
+private:
+  std::vector<double> data;
+public:
+  using base_column::base_column;
+  void ingest(const hyperapi::Value& v){
+    const uint8_t* p = raw(v);
+    if(nullable && !p){
+      valid.set_null(data.size());
+      data.push_back(NA_REAL);
+      return;
+    }
+    data.push_back(static_cast<double>(hyper_read_int64(p)) / MICROSECONDS_PER_SECOND);
+  };
+  size_t size(){ return data.size(); };
+  Rcpp::RObject allocate(R_xlen_t n){
+    Rcpp::DoubleVector out = Rcpp::no_init(n);
+    out.attr("units") = "secs";
+    out.attr("class") = Rcpp::CharacterVector::create("hms", "difftime");
+    return out;
+  };
+  void fill(SEXP target, void* out, R_xlen_t offset){
+    std::copy(data.begin(), data.end(), static_cast<double*>(out) + offset);
+  };
+};
+
+/*
+ * Intervals have a month, a day and a time part that do not convert
+ * into each other, so the column is a data.frame of `months`, `days`
+ * and `microseconds`; e.g. lubridate::period(months = x$months,
+ * days = x$days, seconds = x$microseconds / 1e6) turns it into periods.
+ */
+class interval_column: public base_column {
+private:
+  std::vector<int> months;
+  std::vector<int> days;
+  std::vector<double> microseconds;
+public:
+  using base_column::base_column;
+  void ingest(const hyperapi::Value& v){
+    const uint8_t* p = raw(v);
+    if(nullable && !p){
+      valid.set_null(months.size());
+      months.push_back(NA_INTEGER);
+      days.push_back(NA_INTEGER);
+      microseconds.push_back(NA_REAL);
+      return;
     }
+    hyper_interval_components_t c = hyper_decode_interval(hyper_read_data128(p));
+    months.push_back(c.years * 12 + c.months);
+    days.push_back(c.days);
+    int64_t seconds = (static_cast<int64_t>(c.hours) * 60 + c.minutes) * 60 + c.seconds;
+    microseconds.push_back(static_cast<double>(seconds * MICROSECONDS_PER_SECOND + c.microseconds));
+  };
+  size_t size(){ return months.size(); };
+  Rcpp::RObject allocate(R_xlen_t n){
+    Rcpp::List out = Rcpp::List::create(
+      Rcpp::Named("months") = Rcpp::IntegerVector(Rcpp::no_init(n)),
+      Rcpp::Named("days") = Rcpp::IntegerVector(Rcpp::no_init(n)),
+      Rcpp::Named("microseconds") = Rcpp::DoubleVector(Rcpp::no_init(n))
+    );
+    // The parts are a data.frame, so they share its row limit.
+    if(!set_row_names(out, n)){
+      Rcpp::stop("INTERVAL columns are limited to 2^31 - 1 rows; fetch the result in chunks with `n`.");
+    }
+    out.attr("class") = "data.frame";
     return out;
   };
+  // The parts are reached through the R API.
+  bool needs_r_thread(){ return true; };
+  void fill(SEXP target, void* out, R_xlen_t offset){
+    std::copy(months.begin(), months.end(), INTEGER(VECTOR_ELT(target, 0)) + offset);
+    std::copy(days.begin(), days.end(), INTEGER(VECTOR_ELT(target, 1)) + offset);
+    std::copy(microseconds.begin(), microseconds.end(), REAL(VECTOR_ELT(target, 2)) + offset);
+  };
 };
 
 // typedef void (column::*col_read_fn)(const hyperapi::Value);
@@ -27,8 +27,12 @@ std::string file_name(std::string path_){
 
 namespace RHyper {
 void connection::disconnect(){
+  workers.reset();
+  // Results still open on secondary connections keep their pool alive.
+  secondaries.reset();
   conn_ptr->close();
-  proc_ptr->close();
+  // Releases this connection's lease; hyperd stops with the last one.
+  proc_ptr.reset();
 };
 
 bool connection::is_open(){
@@ -40,43 +44,437 @@ bool connection::is_busy(){
 };
 
 void connection::attach_database(const std::string& db_name_, const std::string& db_alias_){
+  release_result();
   std::string sql_cmd = "ATTACH DATABASE " + hyperapi::escapeName(db_name_) + " AS " + hyperapi::escapeName(db_alias_);
   conn_ptr->executeCommand(sql_cmd);
-  db_name.push_back(db_name_);
+  databases.push_back(database_alias(db_name_, db_alias_));
+  metadata.invalidate();
 };
 
+// Accepts the database's alias or the path it was attached from.
 void connection::detach_database(const std::string& db_name_){
-  fs::path db(db_name_);
-  std::string sql_cmd = "DETACH DATABASE " + db.filename().string();
-  conn_ptr->executeCommand(sql_cmd);
-  db_name.erase(std::remove(db_name.begin(), db_name.end(), db.string()), db_name.end());
+  auto match = [&](const database_alias& d){ return d.second == db_name_ || d.first == db_name_; };
+  auto db = std::find_if(databases.begin(), databases.end(), match);
+  std::string alias = db != databases.end() ? db->second : fs::path(db_name_).stem().string();
+  release_result();
+  conn_ptr->executeCommand("DETACH DATABASE " + hyperapi::escapeName(alias));
+  databases.erase(std::remove_if(databases.begin(), databases.end(), match), databases.end());
+  metadata.invalidate();
+};
+
+void connection::release_result(){
+  auto current_res = res_ptr.lock();
+  if(current_res && current_res->is_open()){
+    Rcpp::warning("Releasing active result set.");
+    current_res->close_and_release();
+  }
+};
+
+std::vector<hyperapi::TableName> connection::list_tables(){
+  if(!metadata.has_tables()){
+    release_result();
+    std::vector<std::string> aliases;
+    for(const auto& d: databases){
+      aliases.push_back(d.second);
+    }
+    metadata.set_tables(catalog_tables(*conn_ptr, aliases));
+  }
+  return metadata.get_tables();
+};
+
+bool connection::has_table(const hyperapi::TableName& name){
+  if(const bool* hit = metadata.find_exists(name)){
+    return *hit;
+  }
+  release_result();
+  bool out = conn_ptr->getCatalog().hasTable(name);
+  // Only found tables are cached: a table that is missing now may be
+  // created by any statement, not just the DDL we get to see.
+  if(out){
+    metadata.set_exists(name, true);
+  }
+  return out;
+};
+
+std::shared_ptr<const hyperapi::TableDefinition> connection::get_table_definition(const hyperapi::TableName& name){
+  if(auto hit = metadata.find_definition(name)){
+    return hit;
+  }
+  release_result();
+  return read_table_definition(name);
+};
+
+std::shared_ptr<const hyperapi::TableDefinition> connection::read_table_definition(const hyperapi::TableName& name){
+  auto out = std::make_shared<const hyperapi::TableDefinition>(conn_ptr->getCatalog().getTableDefinition(name));
+  metadata.set_definition(name, out);
+  metadata.set_exists(name, true);
+  return out;
+};
+
+void connection::set_endpoint(const hyperapi::Endpoint& e, const parameter_map& params){
+  endpoint.reset(new hyperapi::Endpoint(e));
+  conn_params = params;
 };
 
-result_ptr connection::execute_query(std::string sql){
+std::shared_ptr<connection_pool> connection::worker_pool(size_t n){
 
+  if(!endpoint){
+    Rcpp::stop("This connection does not know its endpoint.");
+  }
+  // Worker connections stay open between calls; the pool is only
+  // rebuilt when more of them are needed.
+  if(!workers || workers->get_max_size() < n){
+    pool_options opts;
+    opts.min_size = 0;
+    opts.max_size = n;
+    opts.connection_params = conn_params;
+    workers = std::make_shared<connection_pool>(opts, *endpoint, proc_ptr);
+  }
+  return workers;
+
+};
+
+result_ptr connection::execute_query(std::string sql, bool prepared){
+
+  std::string keyword = begin_statement(sql);
   if(auto current_res = res_ptr.lock()){
-    // If we enter this block, then there is an
+    // A hyperapi::Connection carries one open rowset at a time. While
+    // the current one is still being read, run the new query on a
+    // secondary connection instead of cutting the current one short,
+    // if asked to: that session cannot see temporary tables or an open
+    // transaction of this one.
+    if(concurrent && current_res->check_validity() && current_res->is_open()){
+      if(auto out = execute_on_secondary(sql)){
+        return out;
+      }
+    }
+    // If we get here, then there is an
     // active result set we need to close.
     Rcpp::warning("Releasing active result set.");
     current_res->close_and_release();
   }
   std::unique_ptr<hyperapi::Result> r = std::unique_ptr<hyperapi::Result>(new hyperapi::Result());
-  *r = conn_ptr->executeQuery(sql);
+  if(prepared){
+    *r = execute_prepared(normalize_sql(sql), sql);
+  }else{
+    *r = conn_ptr->executeQuery(sql);
+  }
+  end_statement(sql, keyword);
   std::unique_ptr<hyperapi::ResultIterator> s = std::unique_ptr<hyperapi::ResultIterator>(new hyperapi::ResultIterator(*r, hyperapi::IteratorBeginTag()));
   std::unique_ptr<hyperapi::ResultIterator> e = std::unique_ptr<hyperapi::ResultIterator>(new hyperapi::ResultIterator(*r, hyperapi::IteratorEndTag()));
+  const hyperapi::ResultSchema& schema = r->getSchema();
   auto out = std::shared_ptr<RHyper::result>(new RHyper::result(r, s, e, sql));
+  out->set_plan(make_decode_plan(schema));
   set_current_result(out);
   return out;
 };
 
+// Executes, decodes and closes in one go, for dbGetQuery(). No result
+// object or iterators are created when the connection is free.
+Rcpp::List connection::get_query(const std::string& sql, bool prepared, const std::string& frame){
+
+  auto current_res = res_ptr.lock();
+  if(current_res && current_res->check_validity() && current_res->is_open()){
+    result_ptr r = execute_query(sql, prepared);
+    Rcpp::List out = r->fetch();
+    r->close();
+    set_data_frame(out, frame);
+    return out;
+  }
+  std::string keyword = begin_statement(sql);
+  hyperapi::Result r = prepared ? execute_prepared(normalize_sql(sql), sql) : conn_ptr->executeQuery(sql);
+  end_statement(sql, keyword);
+  return decode_all(r, *make_decode_plan(r.getSchema()), frame);
+
+};
+
+// For dbReadTable(): get_query() on `SELECT * FROM name`, decoded after
+// the table's definition so that NOT NULL columns skip NULL checks. The
+// definition is read afresh, not from the cache: a column wrongly taken
+// for NOT NULL could not be decoded.
+Rcpp::List connection::read_table(const hyperapi::TableName& name, const std::string& frame){
+
+  std::string sql = "SELECT * FROM " + name.toString();
+  auto current_res = res_ptr.lock();
+  if(current_res && current_res->check_validity() && current_res->is_open()){
+    return get_query(sql, false, frame);
+  }
+  auto definition = read_table_definition(name);
+  auto plan = make_decode_plan(*definition);
+  hyperapi::Result r = conn_ptr->executeQuery(sql);
+  if(!plan->matches(r.getSchema())){
+    plan = make_decode_plan(r.getSchema());
+  }
+  return decode_all(r, *plan, frame);
+
+};
+
+Rcpp::List connection::decode_all(hyperapi::Result& r, const decode_plan& plan, const std::string& frame){
+
+  colset_t columns = infer_colset(plan, true);
+  for(const hyperapi::Row& row: r){
+    for(size_t j = 0; j < columns.size(); j++){
+      columns[j]->ingest(row.get<>(j));
+    }
+  }
+  r.close();
+  return as_data_frame(columns, plan.names, frame);
+
+};
+
+// Column names and types of a query's result, found by running it with
+// LIMIT 0: no rows are produced or transferred. The probe is not
+// prepared, so it takes no slot in the statement cache.
+std::shared_ptr<const decode_plan> connection::describe(const std::string& sql){
+
+  release_result();
+  // The newline ends a trailing line comment before the closing paren.
+  std::string probe = "SELECT * FROM (" + strip_terminator(sql) + "\n) AS rhyper_describe LIMIT 0";
+  hyperapi::Result r = conn_ptr->executeQuery(probe);
+  auto plan = make_decode_plan(r.getSchema());
+  r.close();
+  return plan;
+
+};
+
+hyperapi::Result connection::execute_prepared(const std::string& key, const std::string& sql){
+
+  bool cached = statements->contains(key);
+  try{
+    return hyperapi::internal::executePreparedQuery(*conn_ptr, statements->prepare(*conn_ptr, key, sql), HYPER_ROWSET_RESULT_FORMAT_HYPER_BINARY);
+  }
+  catch(const hyperapi::HyperException& e){
+    if(!cached){
+      throw;
+    }
+  }
+  // A cached plan can go stale (e.g. its table was dropped and
+  // recreated); prepare it once more before giving up.
+  statements->forget(key);
+  return hyperapi::internal::executePreparedQuery(*conn_ptr, statements->prepare(*conn_ptr, key, sql), HYPER_ROWSET_RESULT_FORMAT_HYPER_BINARY);
+
+};
+
+// Returns nullptr when no secondary connection can be had (unknown
+// endpoint, or all of them busy with other open results).
+result_ptr connection::execute_on_secondary(const std::string& sql){
+
+  if(!endpoint){
+    return nullptr;
+  }
+  if(!secondaries){
+    pool_options opts;
+    opts.min_size = 0;
+    opts.max_size = MAX_SECONDARY_CONNECTIONS;
+    opts.checkout_timeout = std::chrono::milliseconds(0);
+    opts.connection_params = conn_params;
+    secondaries = std::make_shared<connection_pool>(opts, *endpoint, proc_ptr);
+  }
+  std::unique_ptr<hyperapi::Connection> c;
+  try{
+    c = secondaries->checkout();
+  }
+  catch(...){
+    return nullptr;
+  }
+  std::unique_ptr<hyperapi::Result> r = std::unique_ptr<hyperapi::Result>(new hyperapi::Result());
+  try{
+    // The secondary sees the same attached databases, but not the
+    // primary's temporary tables or uncommitted changes.
+    for(const auto& d: databases){
+      c->executeCommand("ATTACH DATABASE " + hyperapi::escapeName(d.first) + " AS " + hyperapi::escapeName(d.second));
+    }
+    *r = c->executeQuery(sql);
+  }
+  catch(...){
+    secondaries->checkin(std::move(c));
+    throw;
+  }
+  std::unique_ptr<hyperapi::ResultIterator> s = std::unique_ptr<hyperapi::ResultIterator>(new hyperapi::ResultIterator(*r, hyperapi::IteratorBeginTag()));
+  std::unique_ptr<hyperapi::ResultIterator> e = std::unique_ptr<hyperapi::ResultIterator>(new hyperapi::ResultIterator(*r, hyperapi::IteratorEndTag()));
+  const hyperapi::ResultSchema& schema = r->getSchema();
+  auto out = std::shared_ptr<RHyper::result>(new RHyper::result(r, s, e, sql));
+  out->set_plan(make_decode_plan(schema));
+  out->hold_connection(secondaries, std::move(c));
+  return out;
+
+};
+
+std::string connection::begin_statement(const std::string& sql){
+
+  std::string keyword = first_keyword(sql);
+  // A rollback may undo DDL as well.
+  if(keyword == "CREATE" || keyword == "DROP" || keyword == "ALTER" || keyword == "ATTACH" || keyword == "DETACH" ||
+     keyword == "ROLLBACK" || keyword == "ABORT"){
+    metadata.invalidate();
+  }
+  return keyword;
+
+};
+
+void connection::end_statement(const std::string& sql, const std::string& keyword){
+
+  if(keyword == "BEGIN" || keyword == "START"){
+    in_transaction = true;
+  }else if(keyword == "COMMIT" || keyword == "END" || keyword == "ROLLBACK" || keyword == "ABORT"){
+    in_transaction = false;
+  }else if(keyword == "ATTACH"){
+    // Worker and secondary connections attach what is listed here.
+    std::string path, alias;
+    if(parse_attach(sql, path, alias)){
+      databases.push_back(database_alias(path, alias));
+    }
+  }else if(keyword == "DETACH"){
+    std::string alias;
+    if(parse_detach(sql, alias)){
+      auto match = [&](const database_alias& d){ return d.second == alias; };
+      databases.erase(std::remove_if(databases.begin(), databases.end(), match), databases.end());
+    }
+  }
+
+};
+
 int64_t connection::execute_command(std::string sql){
 
+  std::string keyword = begin_statement(sql);
   auto out = conn_ptr->executeCommand(sql);
+  end_statement(sql, keyword);
 
   return out;
 
 };
 
+// Inside a transaction the user began, the statements simply join it;
+// otherwise they get one of their own, rolled back on the first error.
+int64_t connection::execute_batch(const std::vector<std::string>& statements){
+
+  int64_t out = 0;
+  if(in_transaction){
+    for(const auto& sql: statements){
+      out += execute_command(sql);
+    }
+    return out;
+  }
+  execute_command("BEGIN TRANSACTION");
+  try{
+    for(const auto& sql: statements){
+      out += execute_command(sql);
+    }
+  }catch(...){
+    if(in_transaction){
+      // The error that got us here is the one worth reporting.
+      try{ execute_command("ROLLBACK"); }catch(...){ in_transaction = false; }
+    }
+    throw;
+  }
+  execute_command("COMMIT");
+
+  return out;
+
+};
+
+void connection::create_table(const hyperapi::TableDefinition& def, bool replace){
+
+  release_result();
+  metadata.invalidate();
+  if(replace){
+    conn_ptr->executeCommand("DROP TABLE IF EXISTS " + def.getTableName().toString());
+  }
+  conn_ptr->getCatalog().createTable(def);
+
+};
+
+std::unique_ptr<copy_stream> connection::begin_copy(std::string sql, bool csv, bool header){
+
+  if(auto current_res = res_ptr.lock()){
+    Rcpp::warning("Releasing active result set.");
+    current_res->close_and_release();
+  }
+  // The COPY ... FROM STDIN command puts the connection into copy-in
+  // mode; the data itself follows through hyper_copy_data().
+  conn_ptr->executeCommand(sql);
+
+  return std::unique_ptr<copy_stream>(new copy_stream(*conn_ptr, csv, header));
+
+};
+
+std::unique_ptr<hyperapi::Connection> connection::release_handle(){
+
+  if(auto current_res = res_ptr.lock()){
+    Rcpp::warning("Releasing active result set.");
+    current_res->close_and_release();
+  }
+  // Leave a closed connection behind, so later calls on this object
+  // fail with "The connection is closed." instead of crashing.
+  // Prepared statements are per session; do not leave them to the
+  // connection's next user.
+  statements->clear(*conn_ptr);
+  std::unique_ptr<hyperapi::Connection> out = std::move(conn_ptr);
+  conn_ptr.reset(new hyperapi::Connection());
+  workers.reset();
+  secondaries.reset();
+  proc_ptr.reset();
+  databases.clear();
+  metadata.invalidate();
+
+  return out;
+
+};
+
+std::unique_ptr<inserter> connection::create_inserter(const hyperapi::TableName& name, Rcpp::List df, const std::vector<std::string>& mapped, const std::vector<std::string>& expressions){
+
+  if(auto current_res = res_ptr.lock()){
+    Rcpp::warning("Releasing active result set.");
+    current_res->close_and_release();
+  }
+  // Read afresh, as in read_table(): the cached definition may predate
+  // DDL run through dbGetQuery() or another session, and the inserter
+  // must match the table's columns exactly.
+  auto definition = read_table_definition(name);
+  const hyperapi::TableDefinition& table = *definition;
+
+  // Columns of `df` that are also table columns (and not computed) are
+  // written as is. Any other column of `df` is only streamed, typed
+  // after its R class, for use in the expressions. Table columns that
+  // are neither take their default.
+  auto is_mapped = [&](const std::string& col){
+    return std::find(mapped.begin(), mapped.end(), col) != mapped.end();
+  };
+  auto columns = Rcpp::as<std::vector<std::string>>(df.names());
+  hyperapi::TableDefinition target(table.getTableName(), table.getPersistence());
+  hyperapi::TableDefinition stream(table.getTableName(), table.getPersistence());
+  std::vector<std::string> select;
+
+  for(size_t j = 0; j < columns.size(); j++){
+    const hyperapi::TableDefinition::Column* c = table.getColumnByName(columns[j]);
+    if(c != nullptr && !is_mapped(columns[j])){
+      target.addColumn(hyperapi::TableDefinition::Column(*c));
+      stream.addColumn(hyperapi::TableDefinition::Column(*c));
+      select.push_back(c->getName().toString());
+    }else if(c == nullptr && mapped.empty()){
+      Rcpp::stop("Column `" + columns[j] + "` does not exist in table " + name.toString() + ".");
+    }else{
+      stream.addColumn(hyperapi::TableDefinition::Column(columns[j], infer_sql_type(df[j])));
+    }
+  }
+  for(size_t k = 0; k < mapped.size(); k++){
+    const hyperapi::TableDefinition::Column* c = table.getColumnByName(mapped[k]);
+    if(c == nullptr){
+      Rcpp::stop("Mapped column `" + mapped[k] + "` does not exist in table " + name.toString() + ".");
+    }
+    target.addColumn(hyperapi::TableDefinition::Column(*c));
+    select.push_back(expressions[k] + " AS " + c->getName().toString());
+  }
+
+  std::string select_list;
+  for(size_t j = 0; j < select.size(); j++){
+    select_list += (j > 0 ? ", " : "") + select[j];
+  }
+
+  return std::unique_ptr<inserter>(new inserter(*conn_ptr, std::move(target), std::move(stream), select_list));
+
+};
+
 void connection::set_current_result(std::shared_ptr<result> r){
   res_ptr = r;
 };
@@ -90,7 +488,7 @@ void connection::close_current_result(){
 
 bool can_create_connection(){
   try{
-    std::unique_ptr<hyperapi::HyperProcess> hp = std::unique_ptr<hyperapi::HyperProcess>(new hyperapi::HyperProcess());
+    process_lease hp = acquire_process();
     std::unique_ptr<hyperapi::Connection> hc = std::unique_ptr<hyperapi::Connection>(new hyperapi::Connection(hp->getEndpoint()));
     connection conn = connection(hp, hc);
     return true;
@@ -108,22 +506,40 @@ typedef std::unique_ptr<RHyper::connection> conn_ptr;
 // [[Rcpp::export]]
 SEXP connect(
     Rcpp::Nullable<Rcpp::CharacterVector> database_ = R_NilValue,
-    Rcpp::Nullable<Rcpp::CharacterVector> aliases_ = R_NilValue
+    Rcpp::Nullable<Rcpp::CharacterVector> aliases_ = R_NilValue,
+    Rcpp::Nullable<Rcpp::CharacterVector> endpoint_ = R_NilValue,
+    Rcpp::Nullable<Rcpp::CharacterVector> process_params_ = R_NilValue,
+    Rcpp::Nullable<Rcpp::CharacterVector> connection_params_ = R_NilValue
 ){
-  return connect_impl(database_, aliases_);
+  return connect_impl(database_, aliases_, endpoint_, process_params_, connection_params_);
 }
 
 
 SEXP connect_impl(
     Rcpp::Nullable<Rcpp::CharacterVector> database_,
-    Rcpp::Nullable<Rcpp::CharacterVector> aliases_
+    Rcpp::Nullable<Rcpp::CharacterVector> aliases_,
+    Rcpp::Nullable<Rcpp::CharacterVector> endpoint_,
+    Rcpp::Nullable<Rcpp::CharacterVector> process_params_,
+    Rcpp::Nullable<Rcpp::CharacterVector> connection_params_
 ){
 
-  std::unique_ptr<hyperapi::HyperProcess> hp(new hyperapi::HyperProcess());
-  *hp = hyperapi::HyperProcess(hyperapi::Telemetry::DoNotSendUsageDataToTableau);
+  auto connection_map = RHyper::as_parameter_map(connection_params_);
+  auto connection_params = RHyper::as_unordered(connection_map);
+  RHyper::process_lease hp;
+  std::unique_ptr<hyperapi::Endpoint> endpoint;
   std::unique_ptr<hyperapi::Connection> hc(new hyperapi::Connection());
-  *hc = hyperapi::Connection(hp->getEndpoint());
+  if(endpoint_.isNotNull()){
+    // A hyperd we did not start: no lease, so disconnecting leaves it
+    // running. Process settings do not apply.
+    std::string descriptor = Rcpp::as<std::string>(endpoint_.get());
+    endpoint.reset(new hyperapi::Endpoint(descriptor, "RHyper"));
+  }else{
+    hp = RHyper::acquire_process(RHyper::as_parameter_map(process_params_));
+    endpoint.reset(new hyperapi::Endpoint(hp->getEndpoint()));
+  }
+  *hc = hyperapi::Connection(*endpoint, connection_params);
   conn_ptr* out = new conn_ptr(new RHyper::connection(hp, hc));
+  out->get()->set_endpoint(*endpoint, connection_map);
 
   if(database_.isNotNull()){
     auto database = Rcpp::as<std::vector<std::string>>(database_.get());
@@ -165,6 +581,76 @@ void execute_command(SEXP conn_, SEXP statement_){
   return;
 }
 
+// [[Rcpp::export]]
+void attach_database(SEXP conn_, SEXP path_, SEXP alias_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  conn->get()->attach_database(Rcpp::as<std::string>(path_), Rcpp::as<std::string>(alias_));
+}
+
+// [[Rcpp::export]]
+void detach_database(SEXP conn_, SEXP name_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  conn->get()->detach_database(Rcpp::as<std::string>(name_));
+}
+
+// [[Rcpp::export]]
+Rcpp::CharacterVector list_tables(SEXP conn_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  std::vector<std::string> out;
+  for(const auto& t: conn->get()->list_tables()){
+    out.push_back(t.getName().getUnescaped());
+  }
+  return RHyper::utf8_strings(out);
+}
+
+// [[Rcpp::export]]
+bool has_table(SEXP conn_, Rcpp::CharacterVector table_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  auto table = Rcpp::as<std::vector<std::string>>(table_);
+  return conn->get()->has_table(RHyper::make_table_name(table));
+}
+
+// [[Rcpp::export]]
+Rcpp::CharacterVector table_fields(SEXP conn_, Rcpp::CharacterVector table_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  auto table = Rcpp::as<std::vector<std::string>>(table_);
+  auto def = conn->get()->get_table_definition(RHyper::make_table_name(table));
+  std::vector<std::string> out;
+  for(const auto& c: def->getColumns()){
+    out.push_back(c.getName().getUnescaped());
+  }
+  return RHyper::utf8_strings(out);
+}
+
+// [[Rcpp::export]]
+Rcpp::List read_table(SEXP conn_, Rcpp::CharacterVector table_, SEXP frame_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  auto table = Rcpp::as<std::vector<std::string>>(table_);
+  return conn->get()->read_table(RHyper::make_table_name(table), Rcpp::as<std::string>(frame_));
+}
+
+// [[Rcpp::export]]
+void set_concurrent_results(SEXP conn_, bool enabled_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  conn->get()->set_concurrent(enabled_);
+}
+
+// [[Rcpp::export]]
+void statement_cache_resize(SEXP conn_, double size_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  conn->get()->get_statements().resize(static_cast<size_t>(size_));
+}
+
+// [[Rcpp::export]]
+Rcpp::List statement_cache_info(SEXP conn_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  RHyper::statement_cache& cache = conn->get()->get_statements();
+  return Rcpp::List::create(
+    Rcpp::Named("size") = static_cast<double>(cache.size()),
+    Rcpp::Named("capacity") = static_cast<double>(cache.get_capacity())
+  );
+}
+
 // [[Rcpp::export]]
 bool is_valid_connection(SEXP conn_){
   auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
@@ -8,43 +8,105 @@
 #include <algorithm>
 #include "hyperapi/hyperapi.hpp"
 #include "result.h"
+#include "copy.h"
+#include "inserter.h"
+#include "process.h"
+#include "pool.h"
+#include "statements.h"
+#include "catalog.h"
 
 typedef std::shared_ptr<RHyper::result> result_ptr;
 
 namespace RHyper {
 
+// Secondary connections a single connection may lend to concurrently
+// open result sets.
+const size_t MAX_SECONDARY_CONNECTIONS = 8;
+
+// An attached database: (path, alias).
+typedef std::pair<std::string, std::string> database_alias;
+
 class connection {
 private:
-  std::unique_ptr<hyperapi::HyperProcess> proc_ptr;
+  process_lease proc_ptr;
   std::unique_ptr<hyperapi::Connection> conn_ptr;
   std::weak_ptr<result> res_ptr;
-  std::vector<std::string> db_name;
+  std::vector<database_alias> databases;
+  std::unique_ptr<hyperapi::Endpoint> endpoint;
+  parameter_map conn_params;
+  std::shared_ptr<connection_pool> workers;
+  std::shared_ptr<connection_pool> secondaries;
+  bool concurrent = false;
+  // Whether the session is inside a transaction begun by execute_command().
+  bool in_transaction = false;
+  std::unique_ptr<statement_cache> statements = std::unique_ptr<statement_cache>(new statement_cache());
+  result_ptr execute_on_secondary(const std::string& sql);
+  // Runs `sql` as the prepared statement cached under `key`.
+  hyperapi::Result execute_prepared(const std::string& key, const std::string& sql);
+  metadata_cache metadata;
+  // Every path that runs user SQL calls these around it, to keep the
+  // caches and the session state in step: begin_statement() before,
+  // returning the statement's keyword, and end_statement() on success.
+  std::string begin_statement(const std::string& sql);
+  void end_statement(const std::string& sql, const std::string& keyword);
+  void release_result();
+  Rcpp::List decode_all(hyperapi::Result& r, const decode_plan& plan, const std::string& frame);
 public:
   connection(connection const &)=delete;
   connection &operator=(connection const &)=delete;
-  connection(std::unique_ptr<hyperapi::HyperProcess> &p, std::unique_ptr<hyperapi::Connection> &c):
+  connection(process_lease p, std::unique_ptr<hyperapi::Connection> &c):
     proc_ptr(std::move(p)), conn_ptr(std::move(c)) {};
   connection(connection &&o):
-    proc_ptr(std::move(o.proc_ptr)), conn_ptr(std::move(o.conn_ptr)), res_ptr(std::move(o.res_ptr)), db_name(std::move(o.db_name)) {};
+    proc_ptr(std::move(o.proc_ptr)), conn_ptr(std::move(o.conn_ptr)), res_ptr(std::move(o.res_ptr)), databases(std::move(o.databases)),
+    endpoint(std::move(o.endpoint)), conn_params(std::move(o.conn_params)), workers(std::move(o.workers)),
+    secondaries(std::move(o.secondaries)), concurrent(o.concurrent), in_transaction(o.in_transaction), statements(std::move(o.statements)), metadata(std::move(o.metadata)) {};
   connection &operator=(connection &&o){
     if (this != &o)
     {
+      workers = std::move(o.workers);
+      secondaries = std::move(o.secondaries);
+      concurrent = o.concurrent;
+      in_transaction = o.in_transaction;
+      statements = std::move(o.statements);
+      metadata = std::move(o.metadata);
       proc_ptr = std::move(o.proc_ptr);
       conn_ptr = std::move(o.conn_ptr);
       res_ptr = std::move(o.res_ptr);
-      db_name = std::move(o.db_name);
+      databases = std::move(o.databases);
+      endpoint = std::move(o.endpoint);
+      conn_params = std::move(o.conn_params);
     }
     return *this;
   };
+  void set_endpoint(const hyperapi::Endpoint& e, const parameter_map& params);
+  std::shared_ptr<connection_pool> worker_pool(size_t n);
+  const std::vector<database_alias>& get_databases(){ return databases; };
   void disconnect();
   bool is_open();
   bool is_busy();
   void attach_database(const std::string& db_name_, const std::string& db_alias_);
   void detach_database(const std::string& db_name_);
+  std::vector<hyperapi::TableName> list_tables();
+  bool has_table(const hyperapi::TableName& name);
+  std::shared_ptr<const hyperapi::TableDefinition> get_table_definition(const hyperapi::TableName& name);
+  // Bypasses the cache, and refreshes it.
+  std::shared_ptr<const hyperapi::TableDefinition> read_table_definition(const hyperapi::TableName& name);
+  std::shared_ptr<const decode_plan> describe(const std::string& sql);
   void set_current_result(std::shared_ptr<result> r);
   void close_current_result();
   int64_t execute_command(std::string sql);
-  result_ptr execute_query(std::string sql);
+  // Runs all of `statements` or none of them.
+  int64_t execute_batch(const std::vector<std::string>& statements);
+  void create_table(const hyperapi::TableDefinition& def, bool replace = false);
+  result_ptr execute_query(std::string sql, bool prepared = false);
+  Rcpp::List get_query(const std::string& sql, bool prepared = false, const std::string& frame = "data.frame");
+  Rcpp::List read_table(const hyperapi::TableName& name, const std::string& frame = "data.frame");
+  void set_concurrent(bool enabled){ concurrent = enabled; };
+  statement_cache& get_statements(){ return *statements; };
+  std::unique_ptr<copy_stream> begin_copy(std::string sql, bool csv, bool header);
+  std::unique_ptr<hyperapi::Connection> release_handle();
+  const hyperapi::Connection* handle(){ return conn_ptr.get(); };
+  std::unique_ptr<inserter> create_inserter(const hyperapi::TableName& name, Rcpp::List df, const std::vector<std::string>& mapped = {}, const std::vector<std::string>& expressions = {});
 };
 
 }
@@ -53,7 +115,10 @@ typedef std::unique_ptr<RHyper::connection> conn_ptr;
 
 SEXP connect_impl(
     Rcpp::Nullable<Rcpp::CharacterVector> database_ = R_NilValue,
-    Rcpp::Nullable<Rcpp::CharacterVector> aliases_ = R_NilValue
+    Rcpp::Nullable<Rcpp::CharacterVector> aliases_ = R_NilValue,
+    Rcpp::Nullable<Rcpp::CharacterVector> endpoint_ = R_NilValue,
+    Rcpp::Nullable<Rcpp::CharacterVector> process_params_ = R_NilValue,
+    Rcpp::Nullable<Rcpp::CharacterVector> connection_params_ = R_NilValue
 );
 
 SEXP db_detach_impl(Rcpp::Nullable<Rcpp::CharacterVector> = R_NilValue);
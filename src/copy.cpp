@@ -0,0 +1,112 @@
+#include "hyperapi/hyperapi.hpp"
+#include "connection.h"
+#include "copy.h"
+#include <climits>
+#include <Rcpp.h>
+
+typedef std::unique_ptr<RHyper::connection> conn_ptr;
+
+namespace RHyper {
+
+void copy_stream::count_records(const uint8_t* data, size_t size){
+  for(size_t i = 0; i < size; i++){
+    const uint8_t c = data[i];
+    if(csv && c == '"'){
+      // A doubled quote inside a quoted field toggles twice and
+      // therefore leaves the state unchanged.
+      in_quote = !in_quote;
+    }else if(c == '\n' && !in_quote){
+      records++;
+      open_record = false;
+      continue;
+    }
+    open_record = true;
+  }
+};
+
+void copy_stream::write(const uint8_t* data, size_t size){
+  if(!is_open){
+    Rcpp::stop("The COPY stream is already closed.");
+  }
+  count_records(data, size);
+  // hyper_copy_data() takes an int, so very large blocks are split.
+  while(size > 0){
+    size_t n = std::min(size, static_cast<size_t>(INT_MAX));
+    hyperapi::internal::copyData(*conn, data, n);
+    data += n;
+    size -= n;
+    bytes += n;
+  }
+};
+
+void copy_stream::finish(){
+  if(!is_open){
+    Rcpp::stop("The COPY stream is already closed.");
+  }
+  is_open = false;
+  hyperapi::internal::copyEnd(*conn);
+  if(open_record){
+    // The input did not end with a newline.
+    records++;
+    open_record = false;
+  }
+};
+
+void copy_stream::abort(){
+  is_open = false;
+  // There is no explicit "copy fail" in the C API. Cancelling first
+  // makes hyperd reject the COPY instead of committing a partial load.
+  conn->cancel();
+  try{
+    hyperapi::internal::copyEnd(*conn);
+  }
+  catch(...){}
+};
+
+int64_t copy_stream::rows_loaded(){
+  if(header && records > 0){
+    return records - 1;
+  }
+  return records;
+};
+
+double copy_stream::elapsed_seconds(){
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - started;
+  return d.count();
+};
+
+}
+
+// [[Rcpp::export]]
+SEXP copy_begin(SEXP conn_, SEXP statement_, bool csv, bool header){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  std::string statement = Rcpp::as<std::string>(statement_);
+  copy_ptr* out = new copy_ptr(conn->get()->begin_copy(statement, csv, header));
+  return Rcpp::XPtr<copy_ptr>(out, true);
+}
+
+// [[Rcpp::export]]
+void copy_write(SEXP stream_, Rcpp::RawVector block_){
+  auto stream = Rcpp::XPtr<copy_ptr>(stream_);
+  stream->get()->write(RAW(block_), static_cast<size_t>(block_.size()));
+}
+
+// [[Rcpp::export]]
+Rcpp::List copy_end(SEXP stream_){
+  auto stream = Rcpp::XPtr<copy_ptr>(stream_);
+  auto s = stream->get();
+  s->finish();
+  return Rcpp::List::create(
+    Rcpp::Named("rows") = static_cast<double>(s->rows_loaded()),
+    Rcpp::Named("bytes") = static_cast<double>(s->bytes_sent()),
+    Rcpp::Named("seconds") = s->elapsed_seconds()
+  );
+}
+
+// [[Rcpp::export]]
+void copy_abort(SEXP stream_){
+  auto stream = Rcpp::XPtr<copy_ptr>(stream_);
+  if(stream->get()->check_validity()){
+    stream->get()->abort();
+  }
+}
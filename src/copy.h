@@ -0,0 +1,50 @@
+
+#ifndef __RHYPER_COPY__
+#define __RHYPER_COPY__
+
+#include "hyperapi/hyperapi.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace RHyper {
+
+/*
+ * A COPY ... FROM STDIN in progress. Blocks are forwarded to
+ * hyperd as they arrive, so memory use does not depend on the
+ * size of the input. Records are counted on the fly (quote aware
+ * for CSV) so the caller can report rows loaded without asking
+ * the server.
+ */
+class copy_stream {
+private:
+  hyperapi::Connection* conn;
+  bool csv;
+  bool header;
+  bool in_quote = false;
+  bool open_record = false;
+  bool is_open = true;
+  int64_t records = 0;
+  int64_t bytes = 0;
+  std::chrono::steady_clock::time_point started;
+  void count_records(const uint8_t* data, size_t size);
+public:
+  copy_stream(copy_stream const &)=delete;
+  copy_stream &operator=(copy_stream const &)=delete;
+  copy_stream(hyperapi::Connection& c, bool csv_, bool header_):
+    conn(&c), csv(csv_), header(header_), started(std::chrono::steady_clock::now()) {};
+  void write(const uint8_t* data, size_t size);
+  void finish();
+  void abort();
+  bool check_validity(){ return is_open; };
+  int64_t rows_loaded();
+  int64_t bytes_sent(){ return bytes; };
+  double elapsed_seconds();
+  ~copy_stream(){ if(is_open){ abort(); } };
+};
+
+}
+
+typedef std::unique_ptr<RHyper::copy_stream> copy_ptr;
+
+#endif
@@ -0,0 +1,580 @@
+
+#ifndef __RHYPER_ENCODER__
+#define __RHYPER_ENCODER__
+
+#include "hyperapi/hyperapi.hpp"
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Rcpp.h>
+#include "epoch.h"
+
+namespace RHyper {
+
+/*
+ * An encoder writes one R column into Hyper's binary COPY format.
+ * Values are addressed by row so the inserter can interleave columns
+ * row by row; write() follows the hyper_write_* contract and returns
+ * the number of bytes required, writing only if they fit.
+ */
+class base_encoder {
+protected:
+  bool nullable = true;
+public:
+  base_encoder(){};
+  base_encoder(base_encoder const &)=delete;
+  base_encoder &operator=(base_encoder const &)=delete;
+  virtual ~base_encoder(){};
+  virtual void set_nullable(bool n){ nullable = n; };
+  virtual bool is_na(R_xlen_t i) = 0;
+  // Whether a non-missing value can be written to the column's type.
+  virtual bool fits(R_xlen_t i){ return true; };
+  virtual size_t write(R_xlen_t i, uint8_t* target, size_t space) = 0;
+};
+
+inline size_t write_null(uint8_t* target, size_t space){
+  return hyper_write_null(target, space);
+}
+
+inline size_t write_int8(bool nullable, uint8_t* target, size_t space, int8_t v){
+  return nullable ? hyper_write_int8(target, space, v) : hyper_write_int8_not_null(target, space, v);
+}
+
+inline size_t write_int16(bool nullable, uint8_t* target, size_t space, int16_t v){
+  return nullable ? hyper_write_int16(target, space, v) : hyper_write_int16_not_null(target, space, v);
+}
+
+inline size_t write_int32(bool nullable, uint8_t* target, size_t space, int32_t v){
+  return nullable ? hyper_write_int32(target, space, v) : hyper_write_int32_not_null(target, space, v);
+}
+
+inline size_t write_int64(bool nullable, uint8_t* target, size_t space, int64_t v){
+  return nullable ? hyper_write_int64(target, space, v) : hyper_write_int64_not_null(target, space, v);
+}
+
+inline size_t write_double(bool nullable, uint8_t* target, size_t space, double v){
+  int64_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  return write_int64(nullable, target, space, bits);
+}
+
+inline size_t write_data128(bool nullable, uint8_t* target, size_t space, hyper_data128_t v){
+  return nullable ? hyper_write_data128(target, space, v) : hyper_write_data128_not_null(target, space, v);
+}
+
+inline size_t write_varbinary(bool nullable, uint8_t* target, size_t space, const uint8_t* v, size_t n){
+  return nullable ? hyper_write_varbinary(target, space, v, n) : hyper_write_varbinary_not_null(target, space, v, n);
+}
+
+// Doubles in [-2^63, 2^63) convert to int64_t; casting any other value,
+// infinities included, is undefined.
+inline bool fits_int64(double v){
+  return v >= -9223372036854775808.0 && v < 9223372036854775808.0;
+}
+
+inline bool fits_int32(double v){
+  return v > -2147483649.0 && v < 2147483648.0;
+}
+
+inline bool fits_int16(double v){
+  return v > -32769.0 && v < 32768.0;
+}
+
+// 10^scale of a NUMERIC column; its values are sent scaled by this.
+inline int64_t numeric_factor(const hyperapi::SqlType& t){
+  int64_t out = 1;
+  for(uint32_t k = 0; k < t.getScale(); k++){
+    out *= 10;
+  }
+  return out;
+}
+
+class integer_encoder: public base_encoder {
+private:
+  const int* data;
+  hyperapi::TypeTag tag;
+  int64_t factor = 1;
+public:
+  integer_encoder(SEXP x, const hyperapi::SqlType& t): data(INTEGER(x)), tag(t.getTag()) {
+    if(tag == hyperapi::TypeTag::Numeric){
+      factor = numeric_factor(t);
+    }
+  };
+  bool is_na(R_xlen_t i){ return data[i] == NA_INTEGER; };
+  bool fits(R_xlen_t i){
+    switch(tag){
+    case hyperapi::TypeTag::SmallInt:
+      return fits_int16(data[i]);
+    case hyperapi::TypeTag::Numeric:
+      return std::llabs(data[i]) <= INT64_MAX / factor;
+    default:
+      return true;
+    }
+  };
+  size_t write(R_xlen_t i, uint8_t* target, size_t space){
+    if(data[i] == NA_INTEGER){ return write_null(target, space); }
+    switch(tag){
+    case hyperapi::TypeTag::SmallInt:
+      return write_int16(nullable, target, space, static_cast<int16_t>(data[i]));
+    case hyperapi::TypeTag::BigInt:
+      return write_int64(nullable, target, space, data[i]);
+    case hyperapi::TypeTag::Numeric:
+      return write_int64(nullable, target, space, data[i] * factor);
+    case hyperapi::TypeTag::Double:
+      return write_double(nullable, target, space, data[i]);
+    default:
+      return write_int32(nullable, target, space, data[i]);
+    }
+  };
+};
+
+class logical_encoder: public base_encoder {
+private:
+  const int* data;
+public:
+  logical_encoder(SEXP x): data(LOGICAL(x)) {};
+  bool is_na(R_xlen_t i){ return data[i] == NA_LOGICAL; };
+  size_t write(R_xlen_t i, uint8_t* target, size_t space){
+    if(data[i] == NA_LOGICAL){ return write_null(target, space); }
+    return write_int8(nullable, target, space, data[i] != 0);
+  };
+};
+
+class double_encoder: public base_encoder {
+private:
+  const double* data;
+  hyperapi::TypeTag tag;
+  double scale = 1;
+public:
+  double_encoder(SEXP x, const hyperapi::SqlType& t): data(REAL(x)), tag(t.getTag()) {
+    if(tag == hyperapi::TypeTag::Numeric){
+      scale = std::pow(10.0, t.getScale());
+    }
+  };
+  bool is_na(R_xlen_t i){ return std::isnan(data[i]); };
+  bool fits(R_xlen_t i){
+    double v = data[i];
+    switch(tag){
+    case hyperapi::TypeTag::SmallInt:
+      return fits_int16(v);
+    case hyperapi::TypeTag::Int:
+      return fits_int32(v);
+    case hyperapi::TypeTag::BigInt:
+      return fits_int64(v);
+    case hyperapi::TypeTag::Numeric:
+      return fits_int64(v * scale);
+    default:
+      return true;
+    }
+  };
+  size_t write(R_xlen_t i, uint8_t* target, size_t space){
+    if(std::isnan(data[i])){ return write_null(target, space); }
+    switch(tag){
+    case hyperapi::TypeTag::SmallInt:
+      return write_int16(nullable, target, space, static_cast<int16_t>(data[i]));
+    case hyperapi::TypeTag::Int:
+      return write_int32(nullable, target, space, static_cast<int32_t>(data[i]));
+    case hyperapi::TypeTag::BigInt:
+      return write_int64(nullable, target, space, static_cast<int64_t>(data[i]));
+    case hyperapi::TypeTag::Numeric:
+      return write_int64(nullable, target, space, std::llround(data[i] * scale));
+    default:
+      return write_double(nullable, target, space, data[i]);
+    }
+  };
+};
+
+// bit64::integer64 keeps the int64 bit pattern in a double vector.
+class integer64_encoder: public base_encoder {
+private:
+  const int64_t* data;
+public:
+  integer64_encoder(SEXP x): data(reinterpret_cast<const int64_t*>(REAL(x))) {};
+  bool is_na(R_xlen_t i){ return data[i] == INT64_MIN; };
+  size_t write(R_xlen_t i, uint8_t* target, size_t space){
+    if(data[i] == INT64_MIN){ return write_null(target, space); }
+    return write_int64(nullable, target, space, data[i]);
+  };
+};
+
+// Encodes a value into a standalone blob, length prefix included,
+// which can later be copied into a chunk as is.
+inline std::string encode_varbinary(bool nullable, const char* v, size_t n){
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(v);
+  std::string out(write_varbinary(nullable, nullptr, 0, bytes, n), '\0');
+  write_varbinary(nullable, reinterpret_cast<uint8_t*>(&out[0]), out.size(), bytes, n);
+  return out;
+}
+
+inline size_t write_blob(const std::string& blob, uint8_t* target, size_t space){
+  if(blob.size() <= space){
+    std::memcpy(target, blob.data(), blob.size());
+  }
+  return blob.size();
+}
+
+// ASCII and UTF-8 CHARSXPs can be sent without translation.
+inline const char* utf8_chars(SEXP s, size_t* n){
+  if(Rf_charIsASCII(s) || Rf_charIsUTF8(s)){
+    *n = LENGTH(s);
+    return CHAR(s);
+  }
+  const char* v = Rf_translateCharUTF8(s);
+  *n = std::strlen(v);
+  return v;
+}
+
+/*
+ * R keeps a single CHARSXP per distinct string, so repeated values in
+ * a character vector share a pointer. Encoded blobs are cached by that
+ * pointer; once the cache is full (a high-cardinality column) the
+ * remaining strings are written directly.
+ */
+class string_encoder: public base_encoder {
+private:
+  SEXP data;
+  std::unordered_map<SEXP, std::string> cache;
+  size_t cache_bytes = 0;
+  static const size_t CACHE_LIMIT = 64 * 1024 * 1024;
+public:
+  string_encoder(SEXP x): data(x) {};
+  bool is_na(R_xlen_t i){ return STRING_ELT(data, i) == NA_STRING; };
+  size_t write(R_xlen_t i, uint8_t* target, size_t space){
+    SEXP s = STRING_ELT(data, i);
+    if(s == NA_STRING){ return write_null(target, space); }
+    auto it = cache.find(s);
+    if(it != cache.end()){
+      return write_blob(it->second, target, space);
+    }
+    size_t n;
+    const char* v = utf8_chars(s, &n);
+    if(cache_bytes < CACHE_LIMIT){
+      it = cache.emplace(s, encode_varbinary(nullable, v, n)).first;
+      cache_bytes += it->second.size();
+      return write_blob(it->second, target, space);
+    }
+    return write_varbinary(nullable, target, space, reinterpret_cast<const uint8_t*>(v), n);
+  };
+};
+
+/*
+ * Each level is encoded once, in set_nullable() since the blob layout
+ * depends on nullability; rows are a copy of their level's blob.
+ */
+class factor_encoder: public base_encoder {
+private:
+  const int* codes;
+  SEXP levels;
+  std::vector<std::string> blobs;
+  std::vector<uint8_t> level_na;
+public:
+  factor_encoder(SEXP x): codes(INTEGER(x)), levels(Rf_getAttrib(x, R_LevelsSymbol)) {};
+  void set_nullable(bool n){
+    nullable = n;
+    R_xlen_t k = Rf_xlength(levels);
+    blobs.resize(k);
+    level_na.resize(k);
+    for(R_xlen_t l = 0; l < k; l++){
+      SEXP s = STRING_ELT(levels, l);
+      level_na[l] = s == NA_STRING;
+      if(level_na[l]){
+        blobs[l] = std::string(write_null(nullptr, 0), '\0');
+        write_null(reinterpret_cast<uint8_t*>(&blobs[l][0]), blobs[l].size());
+      }else{
+        size_t len;
+        const char* v = utf8_chars(s, &len);
+        blobs[l] = encode_varbinary(nullable, v, len);
+      }
+    }
+  };
+  bool is_na(R_xlen_t i){ return codes[i] == NA_INTEGER || level_na[codes[i] - 1]; };
+  size_t write(R_xlen_t i, uint8_t* target, size_t space){
+    if(codes[i] == NA_INTEGER){ return write_null(target, space); }
+    return write_blob(blobs[codes[i] - 1], target, space);
+  };
+};
+
+class blob_encoder: public base_encoder {
+private:
+  SEXP data;
+public:
+  blob_encoder(SEXP x): data(x) {};
+  bool is_na(R_xlen_t i){ return VECTOR_ELT(data, i) == R_NilValue; };
+  size_t write(R_xlen_t i, uint8_t* target, size_t space){
+    SEXP v = VECTOR_ELT(data, i);
+    if(v == R_NilValue){ return write_null(target, space); }
+    return write_varbinary(nullable, target, space, RAW(v), static_cast<size_t>(Rf_xlength(v)));
+  };
+};
+
+/*
+ * The temporal encoders convert the whole column up front: one pass
+ * reads the values and builds the null mask, and one branch-free pass
+ * does the arithmetic, instead of constructing a hyperapi::Timestamp
+ * per value. Values whose result does not fit are flagged, not cast.
+ */
+class temporal_encoder: public base_encoder {
+protected:
+  std::vector<uint8_t> na;
+  std::vector<uint8_t> overflow;
+  // Converted products stay below this; it is short of 2^63 by more
+  // than their rounding error, so the exact integer result fits too.
+  static constexpr double LIMIT = 9.2e18;
+  // The values as doubles, 0 where missing. R keeps these classes in
+  // double or integer vectors.
+  std::vector<double> read_values(SEXP x){
+    R_xlen_t n = Rf_xlength(x);
+    std::vector<double> out(n);
+    na.resize(n);
+    overflow.assign(n, 0);
+    if(TYPEOF(x) == INTSXP){
+      const int* src = INTEGER(x);
+      for(R_xlen_t i = 0; i < n; i++){
+        na[i] = src[i] == NA_INTEGER;
+        out[i] = na[i] ? 0 : src[i];
+      }
+    }else if(TYPEOF(x) == REALSXP){
+      const double* src = REAL(x);
+      for(R_xlen_t i = 0; i < n; i++){
+        na[i] = !std::isfinite(src[i]);
+        out[i] = na[i] ? 0 : src[i];
+      }
+    }else{
+      Rcpp::stop("Date and time values must be stored as doubles or integers.");
+    }
+    return out;
+  };
+public:
+  bool is_na(R_xlen_t i){ return na[i]; };
+  bool fits(R_xlen_t i){ return !overflow[i]; };
+};
+
+class date_encoder: public temporal_encoder {
+private:
+  // Hyper day numbers, or microseconds when the target is a timestamp.
+  std::vector<int64_t> values;
+  bool as_timestamp;
+public:
+  date_encoder(SEXP x, hyperapi::TypeTag t):
+    as_timestamp(t == hyperapi::TypeTag::Timestamp || t == hyperapi::TypeTag::TimestampTZ) {
+    std::vector<double> src = read_values(x);
+    R_xlen_t n = src.size();
+    values.resize(n);
+    const double origin = unix_epoch_day();
+    for(R_xlen_t i = 0; i < n; i++){
+      double day = origin + std::floor(src[i]);
+      bool ok = as_timestamp ? std::fabs(day * MICROSECONDS_PER_DAY) < LIMIT : fits_int32(day);
+      overflow[i] = !ok;
+      values[i] = ok ? static_cast<int64_t>(day) * (as_timestamp ? MICROSECONDS_PER_DAY : 1) : 0;
+    }
+  };
+  size_t write(R_xlen_t i, uint8_t* target, size_t space){
+    if(na[i]){ return write_null(target, space); }
+    if(as_timestamp){
+      return write_int64(nullable, target, space, values[i]);
+    }
+    return write_int32(nullable, target, space, static_cast<int32_t>(values[i]));
+  };
+};
+
+class timestamp_encoder: public temporal_encoder {
+private:
+  // Hyper microseconds, or day numbers when the target is a date.
+  std::vector<int64_t> values;
+  bool as_date;
+public:
+  timestamp_encoder(SEXP x, hyperapi::TypeTag t): as_date(t == hyperapi::TypeTag::Date) {
+    std::vector<double> src = read_values(x);
+    R_xlen_t n = src.size();
+    values.resize(n);
+    if(as_date){
+      const double origin = unix_epoch_day();
+      for(R_xlen_t i = 0; i < n; i++){
+        double day = origin + std::floor(src[i] / 86400.0);
+        overflow[i] = !fits_int32(day);
+        values[i] = overflow[i] ? 0 : static_cast<int64_t>(day);
+      }
+    }else{
+      const int64_t origin = unix_epoch_microseconds();
+      for(R_xlen_t i = 0; i < n; i++){
+        double us = src[i] * MICROSECONDS_PER_SECOND;
+        overflow[i] = !(std::fabs(us + origin) < LIMIT);
+        values[i] = overflow[i] ? 0 : origin + std::llround(us);
+      }
+    }
+  };
+  size_t write(R_xlen_t i, uint8_t* target, size_t space){
+    if(na[i]){ return write_null(target, space); }
+    if(as_date){
+      return write_int32(nullable, target, space, static_cast<int32_t>(values[i]));
+    }
+    return write_int64(nullable, target, space, values[i]);
+  };
+};
+
+inline double difftime_seconds_per_unit(SEXP x){
+  SEXP units = Rf_getAttrib(x, Rf_install("units"));
+  std::string u = units == R_NilValue ? "secs" : CHAR(STRING_ELT(units, 0));
+  if(u == "secs"){ return 1; }
+  if(u == "mins"){ return 60; }
+  if(u == "hours"){ return 3600; }
+  if(u == "days"){ return 86400; }
+  if(u == "weeks"){ return 7 * 86400; }
+  Rcpp::stop("Unsupported difftime units: " + u);
+}
+
+class difftime_encoder: public temporal_encoder {
+private:
+  std::vector<int64_t> micros;
+  std::vector<hyper_data128_t> intervals;
+  bool as_interval;
+public:
+  difftime_encoder(SEXP x, hyperapi::TypeTag t): as_interval(t == hyperapi::TypeTag::Interval) {
+    std::vector<double> src = read_values(x);
+    R_xlen_t n = src.size();
+    micros.resize(n);
+    const double unit = difftime_seconds_per_unit(x) * MICROSECONDS_PER_SECOND;
+    for(R_xlen_t i = 0; i < n; i++){
+      double us = src[i] * unit;
+      overflow[i] = !(std::fabs(us) < LIMIT);
+      micros[i] = overflow[i] ? 0 : std::llround(us);
+    }
+    if(as_interval){
+      intervals.resize(n);
+      for(R_xlen_t i = 0; i < n; i++){
+        int64_t v = micros[i];
+        int32_t days = static_cast<int32_t>(v / MICROSECONDS_PER_DAY);
+        v -= days * MICROSECONDS_PER_DAY;
+        int32_t seconds = static_cast<int32_t>(v / MICROSECONDS_PER_SECOND);
+        int32_t us = static_cast<int32_t>(v - seconds * MICROSECONDS_PER_SECOND);
+        intervals[i] = hyper_encode_interval({0, 0, days, 0, 0, seconds, us});
+      }
+    }else{
+      for(R_xlen_t i = 0; i < n; i++){
+        if(!na[i] && !overflow[i] && (micros[i] < 0 || micros[i] >= MICROSECONDS_PER_DAY)){
+          Rcpp::stop("difftime values must lie within [0, 24h) to be stored as TIME; use an INTERVAL column instead.");
+        }
+      }
+    }
+  };
+  size_t write(R_xlen_t i, uint8_t* target, size_t space){
+    if(na[i]){ return write_null(target, space); }
+    if(as_interval){
+      return write_data128(nullable, target, space, intervals[i]);
+    }
+    return write_int64(nullable, target, space, micros[i]);
+  };
+};
+
+// The SQL type an R vector is sent as when no table column dictates
+// one; mirrors get_data_type() on the R side.
+inline hyperapi::SqlType infer_sql_type(SEXP x){
+  if(Rf_isFactor(x)){ return hyperapi::SqlType::text(); }
+  if(Rf_inherits(x, "POSIXct")){ return hyperapi::SqlType::timestampTZ(); }
+  if(Rf_inherits(x, "Date")){ return hyperapi::SqlType::date(); }
+  if(Rf_inherits(x, "difftime")){ return hyperapi::SqlType::time(); }
+  if(Rf_inherits(x, "integer64")){ return hyperapi::SqlType::bigInt(); }
+  switch(TYPEOF(x)){
+  case LGLSXP:
+    return hyperapi::SqlType::boolean();
+  case INTSXP:
+    return hyperapi::SqlType::integer();
+  case REALSXP:
+    return hyperapi::SqlType::doublePrecision();
+  case STRSXP:
+    return hyperapi::SqlType::text();
+  case VECSXP:
+    return hyperapi::SqlType::bytes();
+  default:
+    Rcpp::stop("Unsupported type.");
+  }
+}
+
+// Stops unless the column's type is one of `accepted`: a vector sent to
+// a column of another type would put the wrong bytes on the wire.
+inline void check_type(const hyperapi::TableDefinition::Column& col, const std::string& what, std::initializer_list<hyperapi::TypeTag> accepted){
+  for(hyperapi::TypeTag t: accepted){
+    if(col.getType().getTag() == t){
+      return;
+    }
+  }
+  Rcpp::stop("Column `" + col.getName().getUnescaped() + "` is " + col.getType().toString() + " and cannot be written from " + what + ".");
+}
+
+inline std::unique_ptr<base_encoder> make_encoder(SEXP x, const hyperapi::TableDefinition::Column& col){
+  using hyperapi::TypeTag;
+  const hyperapi::SqlType& type = col.getType();
+  const TypeTag tag = type.getTag();
+  std::unique_ptr<base_encoder> out;
+
+  if(Rf_isFactor(x)){
+    check_type(col, "a factor", {TypeTag::Text, TypeTag::Varchar, TypeTag::Char, TypeTag::Json});
+    out.reset(new factor_encoder(x));
+  }else if(Rf_inherits(x, "Date")){
+    check_type(col, "a Date", {TypeTag::Date, TypeTag::Timestamp, TypeTag::TimestampTZ});
+    out.reset(new date_encoder(x, tag));
+  }else if(Rf_inherits(x, "POSIXct")){
+    check_type(col, "a POSIXct", {TypeTag::Timestamp, TypeTag::TimestampTZ, TypeTag::Date});
+    out.reset(new timestamp_encoder(x, tag));
+  }else if(Rf_inherits(x, "difftime")){
+    check_type(col, "a difftime", {TypeTag::Time, TypeTag::Interval});
+    out.reset(new difftime_encoder(x, tag));
+  }else if(Rf_inherits(x, "integer64")){
+    check_type(col, "an integer64", {TypeTag::BigInt});
+    out.reset(new integer64_encoder(x));
+  }else{
+    switch(TYPEOF(x)){
+    case LGLSXP:
+      check_type(col, "a logical", {TypeTag::Bool});
+      out.reset(new logical_encoder(x));
+      break;
+    case INTSXP:
+      check_type(col, "an integer", {TypeTag::SmallInt, TypeTag::Int, TypeTag::BigInt, TypeTag::Numeric, TypeTag::Double});
+      out.reset(new integer_encoder(x, type));
+      break;
+    case REALSXP:
+      check_type(col, "a double", {TypeTag::SmallInt, TypeTag::Int, TypeTag::BigInt, TypeTag::Numeric, TypeTag::Double});
+      out.reset(new double_encoder(x, type));
+      break;
+    case STRSXP:
+      check_type(col, "a character vector", {TypeTag::Text, TypeTag::Varchar, TypeTag::Char, TypeTag::Json});
+      out.reset(new string_encoder(x));
+      break;
+    case VECSXP: {
+      check_type(col, "a list", {TypeTag::Bytes, TypeTag::Geography});
+      R_xlen_t n = Rf_xlength(x);
+      for(R_xlen_t i = 0; i < n; i++){
+        SEXP v = VECTOR_ELT(x, i);
+        if(v != R_NilValue && TYPEOF(v) != RAWSXP){
+          Rcpp::stop("Column `" + col.getName().getUnescaped() + "` is a list, but not of raw vectors.");
+        }
+      }
+      out.reset(new blob_encoder(x));
+      break;
+    }
+    default:
+      Rcpp::stop("Column `" + col.getName().getUnescaped() + "` has an unsupported type.");
+    }
+  }
+
+  bool nullable = col.getNullability() == hyperapi::Nullability::Nullable;
+  out->set_nullable(nullable);
+  R_xlen_t n = Rf_xlength(x);
+  for(R_xlen_t i = 0; i < n; i++){
+    if(out->is_na(i)){
+      if(!nullable){
+        Rcpp::stop("Column `" + col.getName().getUnescaped() + "` is NOT NULL but contains missing values.");
+      }
+    }else if(!out->fits(i)){
+      Rcpp::stop("Column `" + col.getName().getUnescaped() + "` has a value out of range for " + type.toString() + ".");
+    }
+  }
+  return out;
+}
+}
+
+#endif
@@ -0,0 +1,41 @@
+
+#ifndef __RHYPER_EPOCH__
+#define __RHYPER_EPOCH__
+
+#include "hyperapi/hyperapi.hpp"
+#include <cstdint>
+
+namespace RHyper {
+
+const int64_t MICROSECONDS_PER_SECOND = 1000000;
+const int64_t MICROSECONDS_PER_DAY = 86400 * MICROSECONDS_PER_SECOND;
+
+/*
+ * Hyper stores dates as day numbers and timestamps as microseconds
+ * counted from the same (Julian) origin. R counts both from
+ * 1970-01-01, so converting is a single addition once the offset of
+ * the Unix epoch is known.
+ */
+inline int32_t unix_epoch_day(){
+  static const int32_t day = static_cast<int32_t>(hyper_encode_date({1970, 1, 1}));
+  return day;
+}
+
+inline int64_t unix_epoch_microseconds(){
+  return static_cast<int64_t>(unix_epoch_day()) * MICROSECONDS_PER_DAY;
+}
+
+inline int64_t days_since_epoch(const hyperapi::Date& d){
+  hyper_date_components_t c = {d.getYear(), d.getMonth(), d.getDay()};
+  return static_cast<int64_t>(hyper_encode_date(c)) - unix_epoch_day();
+}
+
+inline int64_t microseconds_since_epoch(const hyperapi::Timestamp& ts){
+  const hyperapi::Time& t = ts.getTime();
+  int64_t seconds = (t.getHour() * 60 + t.getMinute()) * 60 + t.getSecond();
+  return days_since_epoch(ts.getDate()) * MICROSECONDS_PER_DAY + seconds * MICROSECONDS_PER_SECOND + t.getMicrosecond();
+}
+
+}
+
+#endif
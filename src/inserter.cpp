@@ -0,0 +1,143 @@
+#include "hyperapi/hyperapi.hpp"
+#include "connection.h"
+#include "inserter.h"
+#include <sstream>
+#include <Rcpp.h>
+
+typedef std::unique_ptr<RHyper::connection> conn_ptr;
+
+namespace RHyper {
+
+// Chunks are handed to hyperd once they pass this size, on a row boundary.
+const size_t CHUNK_LIMIT = 15 * 1024 * 1024;
+
+hyperapi::TableName make_table_name(const std::vector<std::string>& parts){
+  switch(parts.size()){
+  case 1:
+    return hyperapi::TableName(parts[0]);
+  case 2:
+    return hyperapi::TableName(hyperapi::SchemaName(parts[0]), hyperapi::Name(parts[1]));
+  case 3:
+    return hyperapi::TableName(hyperapi::DatabaseName(parts[0]), hyperapi::Name(parts[1]), hyperapi::Name(parts[2]));
+  default:
+    Rcpp::stop("A table name has one to three components (database, schema, table).");
+  }
+};
+
+inserter::inserter(hyperapi::Connection& c, hyperapi::TableDefinition target, hyperapi::TableDefinition stream, std::string select):
+  table_def(std::move(target)), table_handle(table_def), stream_def(std::move(stream)), stream_handle(stream_def), select_list(std::move(select)) {
+
+  chunk.resize(1024 * 1024);
+
+  if(hyper_error_t* error = hyper_create_inserter(hyperapi::internal::getHandle(c), table_handle.get(), &handle)){
+    handle = nullptr;
+    throw hyperapi::internal::makeHyperException(error);
+  }
+
+  init_bulk_insert();
+  new_chunk();
+};
+
+void inserter::init_bulk_insert(){
+  if(hyper_error_t* error = hyper_init_bulk_insert(handle, stream_handle.get(), select_list.c_str())){
+    close();
+    throw hyperapi::internal::makeHyperException(error);
+  }
+};
+
+void inserter::new_chunk(){
+  header_size = hyper_write_header(chunk.data(), chunk.size());
+  offset = header_size;
+};
+
+void inserter::send_chunk(){
+  if(hyper_error_t* error = hyper_inserter_insert_chunk(handle, chunk.data(), offset)){
+    close();
+    throw hyperapi::internal::makeHyperException(error);
+  }
+  bytes += static_cast<int64_t>(offset - header_size);
+  new_chunk();
+};
+
+int64_t inserter::append(Rcpp::List df){
+
+  if(!check_validity()){
+    Rcpp::stop("The inserter is closed.");
+  }
+
+  const auto& columns = stream_def.getColumns();
+  if(static_cast<size_t>(df.size()) != columns.size()){
+    Rcpp::stop("The data frame does not match the columns of the inserter.");
+  }
+
+  std::vector<std::unique_ptr<base_encoder>> encoders;
+  for(size_t j = 0; j < columns.size(); j++){
+    encoders.push_back(make_encoder(df[j], columns[j]));
+  }
+
+  R_xlen_t n = df.size() == 0 ? 0 : Rf_xlength(df[0]);
+
+  for(R_xlen_t i = 0; i < n; i++){
+    for(auto& e: encoders){
+      size_t space = chunk.size() - offset;
+      size_t need = e->write(i, chunk.data() + offset, space);
+      if(need > space){
+        // Nothing was written; grow the buffer and try again.
+        chunk.resize(std::max(chunk.size() * 2, offset + need));
+        need = e->write(i, chunk.data() + offset, chunk.size() - offset);
+      }
+      offset += need;
+    }
+    if(offset >= CHUNK_LIMIT){
+      init_bulk_insert();
+      send_chunk();
+    }
+  }
+
+  return n;
+};
+
+void inserter::execute(){
+  if(!check_validity()){
+    Rcpp::stop("The inserter is closed.");
+  }
+  if(stream_def.getColumnCount() == 0){
+    // Every target column is computed, e.g. from generate_series().
+    if(hyper_error_t* error = hyper_insert_computed_expressions(handle, select_list.c_str())){
+      close();
+      throw hyperapi::internal::makeHyperException(error);
+    }
+  }else if(offset > header_size){
+    send_chunk();
+  }
+  hyper_error_t* error = hyper_close_inserter(handle, true);
+  handle = nullptr;
+  if(error){
+    throw hyperapi::internal::makeHyperException(error);
+  }
+};
+
+void inserter::close(){
+  if(!handle){ return; }
+  // Closing without inserting rolls back whatever was sent so far.
+  if(hyper_error_t* error = hyper_close_inserter(handle, false)){
+    hyperapi::internal::makeHyperException(error);
+  }
+  handle = nullptr;
+};
+
+}
+
+// [[Rcpp::export]]
+double append_table(SEXP conn_, Rcpp::CharacterVector table_, Rcpp::List value_, Rcpp::CharacterVector mapped_, Rcpp::CharacterVector expressions_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  auto table = Rcpp::as<std::vector<std::string>>(table_);
+  auto mapped = Rcpp::as<std::vector<std::string>>(mapped_);
+  auto expressions = Rcpp::as<std::vector<std::string>>(expressions_);
+
+  auto ins = conn->get()->create_inserter(RHyper::make_table_name(table), value_, mapped, expressions);
+  int64_t n = ins->append(value_);
+  ins->execute();
+
+  return static_cast<double>(n);
+}
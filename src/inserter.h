@@ -0,0 +1,57 @@
+
+#ifndef __RHYPER_INSERTER__
+#define __RHYPER_INSERTER__
+
+#include "hyperapi/hyperapi.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+#include <Rcpp.h>
+#include "encoder.h"
+
+namespace RHyper {
+
+hyperapi::TableName make_table_name(const std::vector<std::string>& parts);
+
+/*
+ * Writes data frames into a table with Hyper's binary COPY format.
+ * Unlike hyperapi::Inserter, values are not added one by one through
+ * the C++ wrappers; each column is handed to an encoder and rows are
+ * written straight into the chunk buffer.
+ *
+ * `table_def` lists the target columns and `stream_def` the columns
+ * actually sent. They differ when the select list computes target
+ * columns from expressions over the streamed ones.
+ */
+class inserter {
+private:
+  hyperapi::TableDefinition table_def;
+  hyperapi::internal::HyperTableDefinition table_handle;
+  hyperapi::TableDefinition stream_def;
+  hyperapi::internal::HyperTableDefinition stream_handle;
+  hyper_inserter_t* handle = nullptr;
+  std::string select_list;
+  std::vector<uint8_t> chunk;
+  size_t offset = 0;
+  size_t header_size = 0;
+  int64_t bytes = 0;
+  void new_chunk();
+  void send_chunk();
+  void init_bulk_insert();
+public:
+  inserter(inserter const &)=delete;
+  inserter &operator=(inserter const &)=delete;
+  inserter(hyperapi::Connection& c, hyperapi::TableDefinition target, hyperapi::TableDefinition stream, std::string select);
+  int64_t append(Rcpp::List df);
+  void execute();
+  void close();
+  // For when the connection is gone: the handle can no longer be closed.
+  void abandon(){ handle = nullptr; };
+  bool check_validity(){ return handle != nullptr; };
+  int64_t bytes_written(){ return bytes + static_cast<int64_t>(offset - header_size); };
+  ~inserter(){ close(); };
+};
+
+}
+
+#endif
@@ -0,0 +1,146 @@
+#include "kernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RHYPER_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace RHyper {
+
+namespace {
+
+enum class isa { portable, sse41, avx2 };
+
+isa detect_isa(){
+#ifdef RHYPER_X86_KERNELS
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2")){
+    return isa::avx2;
+  }
+  if(__builtin_cpu_supports("sse4.1")){
+    return isa::sse41;
+  }
+#endif
+  return isa::portable;
+}
+
+isa best_isa(){
+  static const isa out = detect_isa();
+  return out;
+}
+
+template <typename T>
+void widen_portable(const T* in, size_t n, int32_t* out){
+  for(size_t i = 0; i < n; i++){
+    out[i] = static_cast<int32_t>(in[i]);
+  }
+}
+
+#ifdef RHYPER_X86_KERNELS
+
+__attribute__((target("avx2")))
+void widen_int8_avx2(const int8_t* in, size_t n, int32_t* out){
+  size_t i = 0;
+  for(; i + 16 <= n; i += 16){
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvtepi8_epi32(v));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 8), _mm256_cvtepi8_epi32(_mm_srli_si128(v, 8)));
+  }
+  widen_portable(in + i, n - i, out + i);
+}
+
+__attribute__((target("sse4.1")))
+void widen_int8_sse41(const int8_t* in, size_t n, int32_t* out){
+  size_t i = 0;
+  for(; i + 16 <= n; i += 16){
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvtepi8_epi32(v));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 4), _mm_cvtepi8_epi32(_mm_srli_si128(v, 4)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_cvtepi8_epi32(_mm_srli_si128(v, 8)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 12), _mm_cvtepi8_epi32(_mm_srli_si128(v, 12)));
+  }
+  widen_portable(in + i, n - i, out + i);
+}
+
+__attribute__((target("avx2")))
+void widen_int16_avx2(const int16_t* in, size_t n, int32_t* out){
+  size_t i = 0;
+  for(; i + 16 <= n; i += 16){
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvtepi16_epi32(_mm256_castsi256_si128(v)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 8), _mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1)));
+  }
+  widen_portable(in + i, n - i, out + i);
+}
+
+__attribute__((target("sse4.1")))
+void widen_int16_sse41(const int16_t* in, size_t n, int32_t* out){
+  size_t i = 0;
+  for(; i + 8 <= n; i += 8){
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvtepi16_epi32(v));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 4), _mm_cvtepi16_epi32(_mm_srli_si128(v, 8)));
+  }
+  widen_portable(in + i, n - i, out + i);
+}
+
+#endif
+
+// Writes `na` over the values whose bit is clear; words without NULLs
+// cost one comparison.
+void patch_nulls(size_t n, const uint64_t* valid, size_t valid_words, int32_t* out, int32_t na){
+  for(size_t w = 0; w < valid_words; w++){
+    uint64_t nulls = ~valid[w];
+    while(nulls){
+      size_t i = w * 64 + static_cast<size_t>(__builtin_ctzll(nulls));
+      if(i < n){
+        out[i] = na;
+      }
+      nulls &= nulls - 1;
+    }
+  }
+}
+
+}
+
+void widen_int8(const int8_t* in, size_t n, const uint64_t* valid, size_t valid_words, int32_t* out, int32_t na){
+  switch(best_isa()){
+#ifdef RHYPER_X86_KERNELS
+  case isa::avx2:
+    widen_int8_avx2(in, n, out);
+    break;
+  case isa::sse41:
+    widen_int8_sse41(in, n, out);
+    break;
+#endif
+  default:
+    widen_portable(in, n, out);
+  }
+  patch_nulls(n, valid, valid_words, out, na);
+}
+
+void widen_int16(const int16_t* in, size_t n, const uint64_t* valid, size_t valid_words, int32_t* out, int32_t na){
+  switch(best_isa()){
+#ifdef RHYPER_X86_KERNELS
+  case isa::avx2:
+    widen_int16_avx2(in, n, out);
+    break;
+  case isa::sse41:
+    widen_int16_sse41(in, n, out);
+    break;
+#endif
+  default:
+    widen_portable(in, n, out);
+  }
+  patch_nulls(n, valid, valid_words, out, na);
+}
+
+const char* kernel_isa(){
+  switch(best_isa()){
+  case isa::avx2: return "avx2";
+  case isa::sse41: return "sse4.1";
+  default: return "portable";
+  }
+}
+
+}
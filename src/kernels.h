@@ -0,0 +1,30 @@
+
+#ifndef __RHYPER_KERNELS__
+#define __RHYPER_KERNELS__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace RHyper {
+
+/*
+ * Conversions from decoded column values to the storage of R vectors,
+ * with NULLs substituted in the same call. `valid` is a validity bitmap
+ * of `valid_words` 64-bit words (bit set = value present, see
+ * validity_bitmap); values not covered by it are present.
+ *
+ * On x86 the widening runs with AVX2 or SSE4.1, whichever the CPU has
+ * (checked once, at run time); elsewhere a plain loop is used. Only the
+ * words of the bitmap that contain NULLs are looked at afterwards.
+ *
+ * Pure C++, no R API: usable on worker threads and outside R.
+ */
+void widen_int8(const int8_t* in, size_t n, const uint64_t* valid, size_t valid_words, int32_t* out, int32_t na);
+void widen_int16(const int16_t* in, size_t n, const uint64_t* valid, size_t valid_words, int32_t* out, int32_t na);
+
+// "avx2", "sse4.1" or "portable".
+const char* kernel_isa();
+
+}
+
+#endif
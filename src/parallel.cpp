@@ -0,0 +1,178 @@
+#include "hyperapi/hyperapi.hpp"
+#include "connection.h"
+#include "parallel.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <Rcpp.h>
+
+typedef std::unique_ptr<RHyper::connection> conn_ptr;
+
+namespace RHyper {
+
+/*
+ * Everything below runs on worker threads and must not touch the R
+ * API: errors are plain C++ exceptions, caught per query.
+ */
+
+void attach_databases(hyperapi::Connection& c, const std::vector<database_alias>& databases){
+  for(const auto& d: databases){
+    c.executeCommand("ATTACH DATABASE " + hyperapi::escapeName(d.first) + " AS " + hyperapi::escapeName(d.second));
+  }
+};
+
+void read_query(hyperapi::Connection& c, const std::string& sql, query_output& out){
+  hyperapi::Result r = c.executeQuery(sql);
+  const hyperapi::ResultSchema& schema = r.getSchema();
+  out.columns = infer_colset(schema);
+  out.names = column_names(schema);
+  for(const hyperapi::Row& row: r){
+    for(size_t j = 0; j < out.columns.size(); j++){
+      out.columns[j]->ingest(row.get<>(j));
+    }
+  }
+};
+
+std::vector<query_output> run_queries(connection_pool& pool, const std::vector<database_alias>& databases, const std::vector<std::string>& queries, size_t threads){
+
+  std::vector<query_output> out(queries.size());
+  std::vector<uint8_t> done(queries.size(), 0);
+  std::atomic<size_t> next(0);
+  std::mutex error_mutex;
+  std::string checkout_error;
+
+  auto worker = [&](){
+    std::unique_ptr<hyperapi::Connection> c;
+    try{
+      c = pool.checkout();
+      attach_databases(*c, databases);
+    }
+    catch(const std::exception& e){
+      // This worker takes no queries; the others still drain the queue.
+      if(c){
+        pool.checkin(std::move(c));
+      }
+      std::lock_guard<std::mutex> lock(error_mutex);
+      checkout_error = e.what();
+      return;
+    }
+    for(size_t i = next++; i < queries.size(); i = next++){
+      try{
+        read_query(*c, queries[i], out[i]);
+      }
+      catch(const std::exception& e){
+        out[i].error = e.what();
+        out[i].columns.clear();
+      }
+      done[i] = 1;
+    }
+    pool.checkin(std::move(c));
+  };
+
+  threads = std::max<size_t>(1, std::min(threads, queries.size()));
+  std::vector<std::thread> workers;
+  for(size_t t = 0; t < threads; t++){
+    workers.emplace_back(worker);
+  }
+  for(auto& w: workers){
+    w.join();
+  }
+
+  for(size_t i = 0; i < queries.size(); i++){
+    if(!done[i]){
+      out[i].error = "no worker connection could be opened: " + checkout_error;
+    }
+  }
+
+  return out;
+
+};
+
+}
+
+// [[Rcpp::export]]
+Rcpp::List get_queries(SEXP conn_, Rcpp::CharacterVector queries_, double threads_, SEXP frame_){
+
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get()->get();
+  auto queries = Rcpp::as<std::vector<std::string>>(queries_);
+  size_t threads = static_cast<size_t>(threads_);
+
+  auto pool = conn->worker_pool(threads);
+  std::string frame = Rcpp::as<std::string>(frame_);
+  auto outputs = RHyper::run_queries(*pool, conn->get_databases(), queries, threads);
+
+  Rcpp::List out(outputs.size());
+  for(size_t i = 0; i < outputs.size(); i++){
+    if(!outputs[i].error.empty()){
+      Rcpp::stop("Query " + std::to_string(i + 1) + " failed: " + outputs[i].error);
+    }
+    out[i] = RHyper::as_data_frame(outputs[i].columns, outputs[i].names, frame);
+  }
+
+  return out;
+}
+
+// [[Rcpp::export]]
+Rcpp::List read_partitions(SEXP conn_, Rcpp::CharacterVector queries_, double threads_, SEXP frame_){
+
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get()->get();
+  auto queries = Rcpp::as<std::vector<std::string>>(queries_);
+  size_t threads = static_cast<size_t>(threads_);
+
+  auto pool = conn->worker_pool(threads);
+  auto parts = RHyper::run_queries(*pool, conn->get_databases(), queries, threads);
+
+  for(size_t p = 0; p < parts.size(); p++){
+    if(!parts[p].error.empty()){
+      Rcpp::stop("Partition " + std::to_string(p + 1) + " failed: " + parts[p].error);
+    }
+  }
+
+  // Every partition runs the same SELECT, so they share one schema.
+  size_t ncol = parts.empty() ? 0 : parts[0].columns.size();
+  std::vector<R_xlen_t> offsets(parts.size() + 1, 0);
+  for(size_t p = 0; p < parts.size(); p++){
+    offsets[p + 1] = offsets[p] + static_cast<R_xlen_t>(ncol == 0 ? 0 : parts[p].columns[0]->size());
+  }
+
+  Rcpp::List out(ncol);
+  std::vector<SEXP> targets(ncol);
+  std::vector<void*> data(ncol, nullptr);
+  for(size_t j = 0; j < ncol; j++){
+    out[j] = parts[0].columns[j]->allocate(offsets.back());
+    targets[j] = out[j];
+    if(!parts[0].columns[j]->needs_r_thread()){
+      data[j] = RHyper::vector_data(targets[j]);
+    }
+  }
+
+  // Each partition is copied into its own slice of the preallocated
+  // vectors, so the copies do not overlap.
+  std::vector<std::thread> workers;
+  for(size_t p = 0; p < parts.size(); p++){
+    workers.emplace_back([&, p](){
+      for(size_t j = 0; j < ncol; j++){
+        if(data[j] != nullptr){
+          parts[p].columns[j]->fill(targets[j], data[j], offsets[p]);
+        }
+      }
+    });
+  }
+  for(auto& w: workers){
+    w.join();
+  }
+  for(size_t j = 0; j < ncol; j++){
+    if(data[j] == nullptr){
+      for(size_t p = 0; p < parts.size(); p++){
+        parts[p].columns[j]->fill(targets[j], nullptr, offsets[p]);
+      }
+    }
+  }
+
+  if(ncol > 0){
+    out.names() = RHyper::utf8_strings(parts[0].names);
+  }
+  RHyper::set_data_frame(out, Rcpp::as<std::string>(frame_));
+
+  return out;
+}
@@ -0,0 +1,34 @@
+
+#ifndef __RHYPER_PARALLEL__
+#define __RHYPER_PARALLEL__
+
+#include "hyperapi/hyperapi.hpp"
+#include <string>
+#include <vector>
+#include "connection.h"
+#include "pool.h"
+#include "result.h"
+
+namespace RHyper {
+
+// A query's decoded columns, or the reason it failed.
+struct query_output {
+  colset_t columns;
+  std::vector<std::string> names;
+  std::string error;
+};
+
+void attach_databases(hyperapi::Connection& c, const std::vector<database_alias>& databases);
+void read_query(hyperapi::Connection& c, const std::string& sql, query_output& out);
+
+/*
+ * Runs independent queries concurrently on up to `threads` pooled
+ * connections, each with `databases` attached. Rows are decoded on
+ * the worker threads; building R objects from the outputs is left to
+ * the caller, on the R thread.
+ */
+std::vector<query_output> run_queries(connection_pool& pool, const std::vector<database_alias>& databases, const std::vector<std::string>& queries, size_t threads);
+
+}
+
+#endif
@@ -0,0 +1,218 @@
+#include "hyperapi/hyperapi.hpp"
+#include "connection.h"
+#include "pool.h"
+#include <stdexcept>
+#include <Rcpp.h>
+
+typedef std::unique_ptr<RHyper::connection> conn_ptr;
+
+namespace RHyper {
+
+connection_pool::connection_pool(pool_options o):
+  connection_pool(o, acquire_process(o.process_params)) {};
+
+connection_pool::connection_pool(pool_options o, process_lease p):
+  connection_pool(o, p->getEndpoint(), p) {};
+
+// With an endpoint but no lease, the pool connects to a hyperd it does
+// not keep alive (see dbConnect(endpoint = )).
+connection_pool::connection_pool(pool_options o, hyperapi::Endpoint e, process_lease p):
+  proc(std::move(p)), endpoint(std::move(e)), opts(std::move(o)) {
+  if(opts.max_size == 0 || opts.min_size > opts.max_size){
+    throw std::runtime_error("The pool needs 0 <= min_size <= max_size and max_size >= 1.");
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  while(size < opts.min_size){
+    idle.push_back({open_connection(), std::chrono::steady_clock::now()});
+    size++;
+  }
+};
+
+std::unique_ptr<hyperapi::Connection> connection_pool::open_connection(){
+  return std::unique_ptr<hyperapi::Connection>(new hyperapi::Connection(endpoint, as_unordered(opts.connection_params)));
+};
+
+bool connection_pool::validate(hyperapi::Connection& c){
+  if(!c.isOpen() || !c.isReady()){
+    return false;
+  }
+  // hyper_ping only asks the server for its status; it does not run
+  // a query on the connection being checked out.
+  try{
+    return hyperapi::internal::ping(endpoint.getConnectionDescriptor(), "RHyper") == HYPER_PING_OK;
+  }
+  catch(...){
+    return false;
+  }
+};
+
+bool connection_pool::reset(hyperapi::Connection& c){
+  if(!c.isOpen() || !c.isReady()){
+    return false;
+  }
+  try{
+    hyperapi::Catalog& catalog = c.getCatalog();
+    for(const auto& t: catalog.getTableNames(hyperapi::SchemaName("pg_temp"))){
+      c.executeCommand("DROP TABLE IF EXISTS " + t.toString());
+    }
+    catalog.detachAllDatabases();
+    return true;
+  }
+  catch(...){
+    // A connection we cannot clean up is not handed out again.
+    return false;
+  }
+};
+
+void connection_pool::evict_idle(){
+  auto now = std::chrono::steady_clock::now();
+  // The oldest idle connections sit at the front.
+  while(!idle.empty() && size > opts.min_size && now - idle.front().since > opts.idle_timeout){
+    idle.pop_front();
+    size--;
+  }
+};
+
+std::unique_ptr<hyperapi::Connection> connection_pool::checkout(){
+  std::unique_lock<std::mutex> lock(mutex);
+  auto deadline = std::chrono::steady_clock::now() + opts.checkout_timeout;
+  while(true){
+    if(!is_open){
+      throw std::runtime_error("The connection pool is closed.");
+    }
+    evict_idle();
+    while(!idle.empty()){
+      // Most recently returned first: it is the least likely to be stale.
+      std::unique_ptr<hyperapi::Connection> c = std::move(idle.back().conn);
+      idle.pop_back();
+      if(validate(*c)){
+        checked_out.insert(c.get());
+        return c;
+      }
+      size--;
+    }
+    if(size < opts.max_size){
+      size++;
+      lock.unlock();
+      std::unique_ptr<hyperapi::Connection> c;
+      try{
+        c = open_connection();
+      }
+      catch(...){
+        lock.lock();
+        size--;
+        available.notify_one();
+        throw;
+      }
+      lock.lock();
+      checked_out.insert(c.get());
+      return c;
+    }
+    if(available.wait_until(lock, deadline) == std::cv_status::timeout){
+      throw std::runtime_error("Timed out waiting for a pooled connection; all " + std::to_string(opts.max_size) + " are checked out.");
+    }
+  }
+};
+
+// Connections that did not come from this pool, or were returned
+// already, are refused before they can be counted.
+void connection_pool::checkin(std::unique_ptr<hyperapi::Connection> c){
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!c || checked_out.erase(c.get()) == 0){
+      throw std::runtime_error("The connection was not checked out from this pool, or was returned already.");
+    }
+  }
+  bool keep = reset(*c);
+  std::lock_guard<std::mutex> lock(mutex);
+  if(keep && is_open){
+    idle.push_back({std::move(c), std::chrono::steady_clock::now()});
+  }else{
+    size--;
+  }
+  evict_idle();
+  available.notify_one();
+};
+
+bool connection_pool::owns(const hyperapi::Connection* c){
+  std::lock_guard<std::mutex> lock(mutex);
+  return checked_out.count(c) > 0;
+};
+
+void connection_pool::close(){
+  std::lock_guard<std::mutex> lock(mutex);
+  if(!is_open){ return; }
+  is_open = false;
+  size -= idle.size();
+  idle.clear();
+  available.notify_all();
+};
+
+size_t connection_pool::get_size(){
+  std::lock_guard<std::mutex> lock(mutex);
+  return size;
+};
+
+size_t connection_pool::get_idle(){
+  std::lock_guard<std::mutex> lock(mutex);
+  return idle.size();
+};
+
+}
+
+// [[Rcpp::export]]
+SEXP pool_create(
+    double min_size,
+    double max_size,
+    double idle_timeout,
+    double checkout_timeout,
+    Rcpp::Nullable<Rcpp::CharacterVector> process_params_ = R_NilValue,
+    Rcpp::Nullable<Rcpp::CharacterVector> connection_params_ = R_NilValue
+){
+  RHyper::pool_options opts;
+  opts.process_params = RHyper::as_parameter_map(process_params_);
+  opts.connection_params = RHyper::as_parameter_map(connection_params_);
+  opts.min_size = static_cast<size_t>(min_size);
+  opts.max_size = static_cast<size_t>(max_size);
+  opts.idle_timeout = std::chrono::milliseconds(static_cast<int64_t>(idle_timeout * 1000));
+  opts.checkout_timeout = std::chrono::milliseconds(static_cast<int64_t>(checkout_timeout * 1000));
+  pool_ptr* out = new pool_ptr(new RHyper::connection_pool(opts));
+  return Rcpp::XPtr<pool_ptr>(out, true);
+}
+
+// [[Rcpp::export]]
+SEXP pool_checkout(SEXP pool_){
+  auto pool = Rcpp::XPtr<pool_ptr>(pool_).get();
+  std::unique_ptr<hyperapi::Connection> hc = pool->get()->checkout();
+  conn_ptr* out = new conn_ptr(new RHyper::connection(pool->get()->get_process(), hc));
+  out->get()->set_endpoint(pool->get()->get_endpoint(), pool->get()->get_connection_params());
+  return Rcpp::XPtr<conn_ptr>(out, true);
+}
+
+// [[Rcpp::export]]
+void pool_return(SEXP pool_, SEXP conn_){
+  auto pool = Rcpp::XPtr<pool_ptr>(pool_).get();
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  if(!pool->get()->owns(conn->get()->handle())){
+    Rcpp::stop("The connection was not checked out from this pool, or was returned already.");
+  }
+  pool->get()->checkin(conn->get()->release_handle());
+}
+
+// [[Rcpp::export]]
+void pool_close(SEXP pool_){
+  auto pool = Rcpp::XPtr<pool_ptr>(pool_).get();
+  pool->get()->close();
+}
+
+// [[Rcpp::export]]
+Rcpp::List pool_info(SEXP pool_){
+  auto pool = Rcpp::XPtr<pool_ptr>(pool_).get();
+  double size = static_cast<double>(pool->get()->get_size());
+  double idle = static_cast<double>(pool->get()->get_idle());
+  return Rcpp::List::create(
+    Rcpp::Named("size") = size,
+    Rcpp::Named("idle") = idle,
+    Rcpp::Named("checked_out") = size - idle
+  );
+}
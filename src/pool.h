@@ -0,0 +1,79 @@
+
+#ifndef __RHYPER_POOL__
+#define __RHYPER_POOL__
+
+#include "hyperapi/hyperapi.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include "process.h"
+
+namespace RHyper {
+
+struct pool_options {
+  size_t min_size = 1;
+  size_t max_size = 10;
+  std::chrono::milliseconds idle_timeout = std::chrono::minutes(5);
+  std::chrono::milliseconds checkout_timeout = std::chrono::seconds(30);
+  parameter_map process_params;
+  parameter_map connection_params;
+};
+
+/*
+ * A thread-safe pool of open connections to the shared hyperd.
+ * Checkout hands out an idle connection (or opens one while below
+ * max_size) after a cheap health check; checkin resets the session
+ * state and parks the connection until it is reused or has been idle
+ * for longer than idle_timeout. The pool never shrinks below
+ * min_size through eviction.
+ *
+ * Errors are reported as std::runtime_error so the pool can be used
+ * from worker threads.
+ */
+class connection_pool {
+private:
+  struct idle_connection {
+    std::unique_ptr<hyperapi::Connection> conn;
+    std::chrono::steady_clock::time_point since;
+  };
+  process_lease proc;
+  hyperapi::Endpoint endpoint;
+  pool_options opts;
+  std::mutex mutex;
+  std::condition_variable available;
+  std::deque<idle_connection> idle;
+  // Connections handed out and not yet returned; only these are taken back.
+  std::unordered_set<const hyperapi::Connection*> checked_out;
+  size_t size = 0;
+  bool is_open = true;
+  std::unique_ptr<hyperapi::Connection> open_connection();
+  bool validate(hyperapi::Connection& c);
+  bool reset(hyperapi::Connection& c);
+  void evict_idle();
+public:
+  connection_pool(connection_pool const &)=delete;
+  connection_pool &operator=(connection_pool const &)=delete;
+  connection_pool(pool_options o);
+  connection_pool(pool_options o, process_lease p);
+  connection_pool(pool_options o, hyperapi::Endpoint e, process_lease p = nullptr);
+  std::unique_ptr<hyperapi::Connection> checkout();
+  void checkin(std::unique_ptr<hyperapi::Connection> c);
+  bool owns(const hyperapi::Connection* c);
+  void close();
+  process_lease get_process(){ return proc; };
+  const hyperapi::Endpoint& get_endpoint(){ return endpoint; };
+  const parameter_map& get_connection_params(){ return opts.connection_params; };
+  size_t get_max_size(){ return opts.max_size; };
+  size_t get_size();
+  size_t get_idle();
+  ~connection_pool(){ close(); };
+};
+
+}
+
+typedef std::shared_ptr<RHyper::connection_pool> pool_ptr;
+
+#endif
@@ -0,0 +1,91 @@
+#include "hyperapi/hyperapi.hpp"
+#include "process.h"
+#include <mutex>
+#include <Rcpp.h>
+
+namespace RHyper {
+
+namespace {
+std::mutex process_mutex;
+// Not owning: connections keep a process alive, this only finds it.
+std::map<parameter_map, std::weak_ptr<hyperapi::HyperProcess>> shared_processes;
+}
+
+process_lease acquire_process(const parameter_map& params){
+  std::lock_guard<std::mutex> lock(process_mutex);
+  process_lease out = shared_processes[params].lock();
+  if(!out || !out->isOpen()){
+    out = std::make_shared<hyperapi::HyperProcess>(hyperapi::Telemetry::DoNotSendUsageDataToTableau, "RHyper", as_unordered(params));
+    shared_processes[params] = out;
+  }
+  return out;
+};
+
+bool process_running(){
+  std::lock_guard<std::mutex> lock(process_mutex);
+  for(auto& p: shared_processes){
+    process_lease l = p.second.lock();
+    if(l && l->isOpen()){
+      return true;
+    }
+  }
+  return false;
+};
+
+long process_leases(){
+  std::lock_guard<std::mutex> lock(process_mutex);
+  long out = 0;
+  for(auto& p: shared_processes){
+    out += p.second.use_count();
+  }
+  return out;
+};
+
+void shutdown_process(){
+  std::lock_guard<std::mutex> lock(process_mutex);
+  for(auto& p: shared_processes){
+    if(process_lease l = p.second.lock()){
+      // Connections still holding a lease become unusable.
+      l->close();
+    }
+  }
+  shared_processes.clear();
+};
+
+parameter_map as_parameter_map(Rcpp::Nullable<Rcpp::CharacterVector> x){
+  parameter_map out;
+  if(x.isNull()){
+    return out;
+  }
+  Rcpp::CharacterVector v(x.get());
+  if(v.size() == 0){
+    return out;
+  }
+  auto values = Rcpp::as<std::vector<std::string>>(v);
+  auto keys = Rcpp::as<std::vector<std::string>>(v.names());
+  for(size_t i = 0; i < values.size(); i++){
+    out[keys[i]] = values[i];
+  }
+  return out;
+};
+
+std::unordered_map<std::string, std::string> as_unordered(const parameter_map& params){
+  return std::unordered_map<std::string, std::string>(params.begin(), params.end());
+};
+
+}
+
+// [[Rcpp::export]]
+bool hyper_process_running(){
+  return RHyper::process_running();
+}
+
+// [[Rcpp::export]]
+int hyper_process_leases(){
+  return static_cast<int>(RHyper::process_leases());
+}
+
+// [[Rcpp::export]]
+void hyper_process_shutdown(){
+  RHyper::shutdown_process();
+}
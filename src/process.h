@@ -0,0 +1,34 @@
+
+#ifndef __RHYPER_PROCESS__
+#define __RHYPER_PROCESS__
+
+#include "hyperapi/hyperapi.hpp"
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <Rcpp.h>
+
+namespace RHyper {
+
+/*
+ * Connections started with the same process settings share one
+ * hyperd. A connection holds a lease (a shared_ptr) on its process;
+ * the process is shut down when the last lease is released, or at
+ * unload.
+ */
+typedef std::shared_ptr<hyperapi::HyperProcess> process_lease;
+typedef std::map<std::string, std::string> parameter_map;
+
+process_lease acquire_process(const parameter_map& params = {});
+bool process_running();
+// Leases held on all shared processes.
+long process_leases();
+void shutdown_process();
+
+parameter_map as_parameter_map(Rcpp::Nullable<Rcpp::CharacterVector> x);
+std::unordered_map<std::string, std::string> as_unordered(const parameter_map& params);
+
+}
+
+#endif
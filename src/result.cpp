@@ -7,23 +7,75 @@ typedef std::unique_ptr<RHyper::connection> conn_ptr;
 typedef std::shared_ptr<RHyper::result> result_ptr;
 typedef std::vector<std::unique_ptr<RHyper::base_column>> colset_t;
 
+// Decoding follows the plan cached for the statement when there is one;
+// otherwise it is worked out from the schema once per result.
+std::shared_ptr<const RHyper::decode_plan> RHyper::result::get_plan(){
+  if(!plan){
+    plan = res_ptr ? RHyper::make_decode_plan(res_ptr->getSchema()) : std::make_shared<const RHyper::decode_plan>();
+  }
+  return plan;
+};
+
 colset_t RHyper::result::infer_colset(){
-  auto schema = res_ptr->getSchema();
+  return RHyper::infer_colset(*get_plan(), true);
+};
+
+std::vector<std::string> RHyper::result::get_column_names(){
+  return get_plan()->names;
+}
+
+void RHyper::result::return_connection(){
+  if(!borrowed){
+    return;
+  }
+  // The rowset must be closed before its connection is reset and reused.
+  if(res_ptr){
+    res_ptr->close();
+  }
+  try{
+    lender->checkin(std::move(borrowed));
+  }
+  catch(...){
+    // Never throw from a destructor; the connection is simply dropped.
+  }
+  borrowed.reset();
+  lender.reset();
+}
+
+// Pure C++ (no R API calls), so it can also run on worker threads.
+colset_t RHyper::infer_colset(const hyperapi::ResultSchema& schema){
+  return RHyper::infer_colset(*RHyper::make_decode_plan(schema));
+};
+
+colset_t RHyper::infer_colset(const RHyper::decode_plan& plan, bool on_r_thread){
   colset_t out;
 
-  for(int j = 0; j < schema.getColumnCount(); j++){
-    auto t = schema.getColumn(j).getType().getTag();
+  for(size_t j = 0; j < plan.types.size(); j++){
+    auto t = plan.types[j].getTag();
+    bool nullable = plan.is_nullable(j);
     // Rcpp::Rcout << schema.getColumn(j).getType().toString() << std::endl;
     switch(t){
     case hyperapi::TypeTag::Int:
     {
-      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::integer_column());
+      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::integer_column(nullable));
+      out.push_back(std::move(col));
+      break;
+    }
+    case hyperapi::TypeTag::SmallInt:
+    {
+      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::smallint_column(nullable));
+      out.push_back(std::move(col));
+      break;
+    }
+    case hyperapi::TypeTag::Oid:
+    {
+      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::oid_column(nullable));
       out.push_back(std::move(col));
       break;
     }
     case hyperapi::TypeTag::Bool:
     {
-      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::bool_column());
+      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::bool_column(nullable));
       out.push_back(std::move(col));
       break;
     }
@@ -31,40 +83,152 @@ colset_t RHyper::result::infer_colset(){
     case hyperapi::TypeTag::BigInt:
     case hyperapi::TypeTag::Double:
     {
-      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::double_column());
+      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::double_column(nullable));
       out.push_back(std::move(col));
       break;
     }
     case hyperapi::TypeTag::Text:
+    case hyperapi::TypeTag::Varchar:
+    case hyperapi::TypeTag::Char:
+    case hyperapi::TypeTag::Json:
+    {
+      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::string_column(nullable));
+      out.push_back(std::move(col));
+      break;
+    }
+    case hyperapi::TypeTag::Bytes:
+    case hyperapi::TypeTag::Geography:
     {
-      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::string_column());
+      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::bytes_column(nullable, on_r_thread));
       out.push_back(std::move(col));
       break;
     }
     case hyperapi::TypeTag::Date:
     {
-      auto col = std::unique_ptr<RHyper::date_column>(new RHyper::date_column());
+      auto col = std::unique_ptr<RHyper::date_column>(new RHyper::date_column(nullable));
       out.push_back(std::move(col));
       break;
     }
     case hyperapi::TypeTag::Timestamp:
     case hyperapi::TypeTag::TimestampTZ:
     {
-      auto col = std::unique_ptr<RHyper::timestamp_column>(new RHyper::timestamp_column());
+      auto col = std::unique_ptr<RHyper::timestamp_column>(new RHyper::timestamp_column(nullable));
+      out.push_back(std::move(col));
+      break;
+    }
+    case hyperapi::TypeTag::Time:
+    {
+      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::time_column(nullable));
+      out.push_back(std::move(col));
+      break;
+    }
+    case hyperapi::TypeTag::Interval:
+    {
+      auto col = std::unique_ptr<RHyper::base_column>(new RHyper::interval_column(nullable));
       out.push_back(std::move(col));
       break;
     }
     default:
     {
-      Rcpp::stop("Unsupported type.");
+      throw std::runtime_error("Unsupported type: " + plan.types[j].toString() + ".");
     }
     };
   }
   return out;
 };
 
-std::vector<std::string> RHyper::result::get_column_names(){
-  auto schema = res_ptr->getSchema();
+static std::string r_class(hyperapi::TypeTag t){
+  switch(t){
+  case hyperapi::TypeTag::SmallInt:
+  case hyperapi::TypeTag::Int: return "integer";
+  case hyperapi::TypeTag::Bool: return "logical";
+  case hyperapi::TypeTag::Numeric:
+  case hyperapi::TypeTag::BigInt:
+  case hyperapi::TypeTag::Oid:
+  case hyperapi::TypeTag::Double: return "numeric";
+  case hyperapi::TypeTag::Text:
+  case hyperapi::TypeTag::Varchar:
+  case hyperapi::TypeTag::Char:
+  case hyperapi::TypeTag::Json: return "character";
+  case hyperapi::TypeTag::Bytes:
+  case hyperapi::TypeTag::Geography: return "blob";
+  case hyperapi::TypeTag::Time: return "hms";
+  case hyperapi::TypeTag::Interval: return "data.frame";
+  case hyperapi::TypeTag::Date: return "Date";
+  case hyperapi::TypeTag::Timestamp:
+  case hyperapi::TypeTag::TimestampTZ: return "POSIXct";
+  default: return "unsupported";
+  }
+}
+
+// In the shape of DBI::dbColumnInfo(). Nullability is not part of a
+// result's types, so it is reported as NA unless the plan knows it.
+Rcpp::List RHyper::column_info(const RHyper::decode_plan& plan){
+  size_t n = plan.types.size();
+  Rcpp::CharacterVector type(n), sql_type(n);
+  Rcpp::IntegerVector precision(n), scale(n);
+  Rcpp::LogicalVector nullable(n, NA_LOGICAL);
+  if(!plan.nullable.empty()){
+    for(size_t j = 0; j < n; j++){
+      nullable[j] = plan.nullable[j];
+    }
+  }
+  for(size_t j = 0; j < n; j++){
+    const hyperapi::SqlType& t = plan.types[j];
+    type[j] = r_class(t.getTag());
+    sql_type[j] = t.toString();
+    bool is_numeric = t.getTag() == hyperapi::TypeTag::Numeric;
+    precision[j] = is_numeric ? static_cast<int>(t.getPrecision()) : NA_INTEGER;
+    scale[j] = is_numeric ? static_cast<int>(t.getScale()) : NA_INTEGER;
+  }
+  Rcpp::List out = Rcpp::List::create(
+    Rcpp::Named("name") = RHyper::utf8_strings(plan.names),
+    Rcpp::Named("type") = type,
+    Rcpp::Named("sql.type") = sql_type,
+    Rcpp::Named("precision") = precision,
+    Rcpp::Named("scale") = scale,
+    Rcpp::Named("nullable") = nullable
+  );
+  return out;
+}
+
+// Rows of a column; INTERVAL columns are data.frames themselves.
+static R_xlen_t column_rows(SEXP x){
+  if(Rf_inherits(x, "data.frame")){
+    return Rf_xlength(x) == 0 ? 0 : Rf_xlength(VECTOR_ELT(x, 0));
+  }
+  return Rf_xlength(x);
+}
+
+// Turns a named list of equal-length columns into a data.frame in place:
+// no copy of the columns, compact row names. `frame` = "tibble" adds
+// the tibble classes; a data.table is finished on the R side, which
+// has to over-allocate it.
+void RHyper::set_data_frame(Rcpp::List& columns, const std::string& frame){
+  R_xlen_t n = columns.size() == 0 ? 0 : column_rows(columns[0]);
+  if(!set_row_names(columns, n)){
+    // The long-vector columns are returned as a plain list.
+    Rcpp::warning("The result has more than 2^31 - 1 rows; it is returned as a list of columns.");
+    return;
+  }
+  if(frame == "tibble"){
+    columns.attr("class") = Rcpp::CharacterVector::create("tbl_df", "tbl", "data.frame");
+  }else{
+    columns.attr("class") = "data.frame";
+  }
+}
+
+Rcpp::List RHyper::as_data_frame(colset_t& columns, const std::vector<std::string>& names, const std::string& frame){
+  Rcpp::List out(columns.size());
+  for(size_t j = 0; j < columns.size(); j++){
+    out[j] = columns[j]->to_sexp();
+  }
+  out.names() = RHyper::utf8_strings(names);
+  set_data_frame(out, frame);
+  return out;
+}
+
+std::vector<std::string> RHyper::column_names(const hyperapi::ResultSchema& schema){
   std::vector<std::string> out;
   for(auto col: schema.getColumns()){
     out.push_back(col.getName().getUnescaped());
@@ -73,11 +237,11 @@ std::vector<std::string> RHyper::result::get_column_names(){
 }
 
 // [[Rcpp::export]]
-SEXP create_result2(SEXP conn_, SEXP statement_){
+SEXP create_result2(SEXP conn_, SEXP statement_, bool immutable_ = false){
   auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
   std::string statement = Rcpp::as<std::string>(statement_);
   result_ptr* out = new result_ptr(new RHyper::result());
-  *out = conn->get()->execute_query(statement);
+  *out = conn->get()->execute_query(statement, immutable_);
   return Rcpp::XPtr<result_ptr>(out, true);
 }
 
@@ -88,16 +252,17 @@ void clear_result2(SEXP res_){
 }
 
 // [[Rcpp::export]]
-Rcpp::List fetch_rows(SEXP res_, Rcpp::Nullable<int> n_ = R_NilValue){
+Rcpp::List fetch_rows(SEXP res_, SEXP frame_, Rcpp::Nullable<double> n_ = R_NilValue){
   auto res = Rcpp::XPtr<result_ptr>(res_);
+  Rcpp::List out;
   if(n_.isNull()){
-    auto out = res->get()->fetch();
-    return out;
+    out = res->get()->fetch();
   }else{
-    int n = Rcpp::as<int>(n_);
-    auto out = res->get()->fetch(n);
-    return out;
+    R_xlen_t n = static_cast<R_xlen_t>(Rcpp::as<double>(n_));
+    out = res->get()->fetch(n);
   }
+  RHyper::set_data_frame(out, Rcpp::as<std::string>(frame_));
+  return out;
 }
 
 // [[Rcpp::export]]
@@ -117,3 +282,24 @@ bool is_valid_result(SEXP res_){
   }
   return res->get()->check_validity();
 }
+
+// [[Rcpp::export]]
+Rcpp::List result_column_info(SEXP res_){
+  auto res = Rcpp::XPtr<result_ptr>(res_).get();
+  if(res->get()->is_pending()){
+    Rcpp::stop("The query has parameters; call dbBind() first.");
+  }
+  return RHyper::column_info(*res->get()->get_plan());
+}
+
+// [[Rcpp::export]]
+Rcpp::List get_query(SEXP conn_, SEXP statement_, SEXP frame_, bool immutable_ = false){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  return conn->get()->get_query(Rcpp::as<std::string>(statement_), immutable_, Rcpp::as<std::string>(frame_));
+}
+
+// [[Rcpp::export]]
+Rcpp::List describe_query(SEXP conn_, SEXP statement_){
+  auto conn = Rcpp::XPtr<conn_ptr>(conn_).get();
+  return RHyper::column_info(*conn->get()->describe(Rcpp::as<std::string>(statement_)));
+}
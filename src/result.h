@@ -4,30 +4,61 @@
 
 #include "hyperapi/hyperapi.hpp"
 #include <memory>
+#include <stdexcept>
 #include <Rcpp.h>
 #include "column.h"
+#include "pool.h"
+#include "catalog.h"
 
 typedef std::vector<std::unique_ptr<RHyper::base_column>> colset_t;
 
 namespace RHyper {
 
+// Columns decoded on the R thread may build R objects as they go.
+colset_t infer_colset(const decode_plan& plan, bool on_r_thread = false);
+colset_t infer_colset(const hyperapi::ResultSchema& schema);
+Rcpp::List column_info(const decode_plan& plan);
+// A data.frame (with compact row names) holding the decoded columns.
+Rcpp::List as_data_frame(colset_t& columns, const std::vector<std::string>& names, const std::string& frame = "data.frame");
+void set_data_frame(Rcpp::List& columns, const std::string& frame = "data.frame");
+std::vector<std::string> column_names(const hyperapi::ResultSchema& schema);
+
+/*
+ * A result set may run on a secondary connection borrowed from its
+ * connection's pool (see connection::execute_query). It then owns that
+ * connection and hands it back once closed; `borrowed` is declared
+ * before `res_ptr` so the rowset is always destroyed first.
+ */
 class result {
 private:
+  std::shared_ptr<connection_pool> lender;
+  std::unique_ptr<hyperapi::Connection> borrowed;
   std::unique_ptr<hyperapi::Result> res_ptr = std::unique_ptr<hyperapi::Result>(nullptr);
   std::unique_ptr<hyperapi::ResultIterator> iter_start_ptr = std::unique_ptr<hyperapi::ResultIterator>(nullptr);
   std::unique_ptr<hyperapi::ResultIterator> iter_end_ptr = std::unique_ptr<hyperapi::ResultIterator>(nullptr);
   std::string statement;
   bool is_valid = true;
+  bool pending = false;
+  int64_t bound_rows = -1;
+  int64_t rows_affected = -1;
+  bool split = false;
+  std::string staging;
+  std::shared_ptr<const decode_plan> plan;
 public:
   result(){};
+  // A statement with placeholders, waiting for dbBind().
+  explicit result(std::string sql): statement(sql), pending(true) {};
   result(result const &)=delete;
   result &operator=(result const &)=delete;
   result(std::unique_ptr<hyperapi::Result> &r, std::unique_ptr<hyperapi::ResultIterator> &s, std::unique_ptr<hyperapi::ResultIterator> &e, std::string sql):
     res_ptr(std::move(r)), iter_start_ptr(std::move(s)), iter_end_ptr(std::move(e)), statement(sql) {};
-  result(result &&o) : res_ptr(std::move(o.res_ptr)), iter_start_ptr(std::move(o.iter_start_ptr)), iter_end_ptr(std::move(o.iter_end_ptr)), statement(std::move(o.statement)) {};
+  result(result &&o) : lender(std::move(o.lender)), borrowed(std::move(o.borrowed)), res_ptr(std::move(o.res_ptr)), iter_start_ptr(std::move(o.iter_start_ptr)), iter_end_ptr(std::move(o.iter_end_ptr)), statement(std::move(o.statement)) {};
   result &operator=(result &&o){
     if (this != &o)
     {
+      return_connection();
+      lender = std::move(o.lender);
+      borrowed = std::move(o.borrowed);
       res_ptr = std::move(o.res_ptr);
       iter_start_ptr = std::move(o.iter_start_ptr);
       iter_end_ptr = std::move(o.iter_end_ptr);
@@ -35,7 +66,54 @@ public:
     }
     return *this;
   };
-  bool is_open(){ return res_ptr->isOpen(); };
+  void hold_connection(std::shared_ptr<connection_pool> p, std::unique_ptr<hyperapi::Connection> c){
+    lender = std::move(p);
+    borrowed = std::move(c);
+  };
+  bool on_secondary(){ return borrowed != nullptr; };
+  void return_connection();
+  bool is_open(){ return res_ptr && res_ptr->isOpen(); };
+  bool is_pending(){ return pending; };
+  void set_plan(std::shared_ptr<const decode_plan> p){ plan = std::move(p); };
+  std::shared_ptr<const decode_plan> get_plan();
+  // Takes over the rowset of `o`, the batch run for bound parameters.
+  void take_rowset(result& o){
+    return_connection();
+    iter_start_ptr.reset();
+    iter_end_ptr.reset();
+    res_ptr.reset();
+    lender = std::move(o.lender);
+    borrowed = std::move(o.borrowed);
+    res_ptr = std::move(o.res_ptr);
+    iter_start_ptr = std::move(o.iter_start_ptr);
+    iter_end_ptr = std::move(o.iter_end_ptr);
+    plan = std::move(o.plan);
+    pending = false;
+    is_valid = true;
+  };
+  void set_binding(int64_t rows, bool split_rows, std::string staging_table){
+    bound_rows = rows;
+    split = split_rows;
+    staging = staging_table;
+  };
+  void set_rows_affected(int64_t n){
+    pending = false;
+    rows_affected = n;
+  };
+  int64_t get_bound_rows(){ return bound_rows; };
+  // For a statement run without parameters, Hyper only knows the count
+  // once all of its rows (usually none) have been read.
+  int64_t get_rows_affected(){
+    if(rows_affected < 0 && is_open() && is_tapped()){
+      auto n = res_ptr->getAffectedRowCount();
+      if(n){
+        rows_affected = static_cast<int64_t>(*n);
+      }
+    }
+    return rows_affected;
+  };
+  bool get_split(){ return split; };
+  const std::string& get_staging(){ return staging; };
   bool is_tapped(){
     bool out = *iter_start_ptr == *iter_end_ptr;
     return out;
@@ -45,22 +123,28 @@ public:
   };
   colset_t infer_colset();
   std::vector<std::string> get_column_names();
-  Rcpp::List fetch(int n = -1){
+  Rcpp::List fetch(R_xlen_t n = -1){
+    if(pending){
+      Rcpp::stop("The query has parameters; call dbBind() before fetching.");
+    }
+    if(!res_ptr){
+      return Rcpp::List();
+    }
     colset_t column_set = infer_colset();
     std::vector<std::string> col_names = get_column_names();
     if(n == -1){
       while(*iter_start_ptr != *iter_end_ptr){
         const hyperapi::Row& r = **iter_start_ptr;
-        for(int j = 0; j < column_set.size(); j++){
+        for(size_t j = 0; j < column_set.size(); j++){
           (*column_set[j]).ingest(r.get<>(j));
         }
         ++(*iter_start_ptr);
       }
     }else{
-      int i = 0;
+      R_xlen_t i = 0;
       while(*iter_start_ptr != *iter_end_ptr){
         const hyperapi::Row& r = **iter_start_ptr;
-        for(int j = 0; j < column_set.size(); j++){
+        for(size_t j = 0; j < column_set.size(); j++){
           (*column_set[j]).ingest(r.get<>(j));
         }
         i++;
@@ -69,12 +153,12 @@ public:
       }
     }
     std::vector<Rcpp::RObject> tmp;
-    for(int j = 0; j < column_set.size(); j++){
+    for(size_t j = 0; j < column_set.size(); j++){
       tmp.push_back((*column_set[j]).to_sexp());
     }
 
     Rcpp::List out = Rcpp::wrap(tmp);
-    out.names() = col_names;
+    out.names() = utf8_strings(col_names);
 
     // If the result set is tapped, update the status of the
     // result (e.g. is_active = false).
@@ -82,17 +166,19 @@ public:
     return out;
   };
   void close(){
-    res_ptr->close();
+    if(res_ptr){ res_ptr->close(); }
     is_valid = false;
+    return_connection();
   };
   void close_and_release(){
-    res_ptr->close();
+    if(res_ptr){ res_ptr->close(); }
     is_valid = false;
+    return_connection();
   };
   bool check_validity(){
     return is_valid;
   };
-  ~result(){};
+  ~result(){ return_connection(); };
 };
 
 }
@@ -0,0 +1,232 @@
+#include "hyperapi/hyperapi.hpp"
+#include "statements.h"
+#include <cctype>
+
+namespace RHyper {
+
+// Collapses whitespace, drops comments outside of quotes and drops a
+// trailing semicolon, so trivially reformatted queries share a
+// statement. This is only a cache key: the original text is prepared.
+std::string normalize_sql(const std::string& sql){
+  std::string out;
+  out.reserve(sql.size());
+  char quote = 0;
+  bool pending_space = false;
+  size_t i = 0;
+  while(i < sql.size()){
+    char ch = sql[i];
+    if(quote){
+      out.push_back(ch);
+      if(ch == quote){ quote = 0; }
+      i++;
+      continue;
+    }
+    if(ch == '-' && i + 1 < sql.size() && sql[i + 1] == '-'){
+      size_t close = sql.find('\n', i);
+      i = (close == std::string::npos) ? sql.size() : close + 1;
+      pending_space = !out.empty();
+      continue;
+    }
+    if(ch == '/' && i + 1 < sql.size() && sql[i + 1] == '*'){
+      size_t close = sql.find("*/", i + 2);
+      i = (close == std::string::npos) ? sql.size() : close + 2;
+      pending_space = !out.empty();
+      continue;
+    }
+    i++;
+    if(std::isspace(static_cast<unsigned char>(ch))){
+      pending_space = !out.empty();
+      continue;
+    }
+    if(pending_space){
+      out.push_back(' ');
+      pending_space = false;
+    }
+    if(ch == '\'' || ch == '"'){
+      quote = ch;
+    }
+    out.push_back(ch);
+  }
+  while(!quote && !out.empty() && (out.back() == ';' || out.back() == ' ')){
+    out.pop_back();
+  }
+  return out;
+};
+
+// Drops trailing whitespace and semicolons, for use as a subquery.
+std::string strip_terminator(const std::string& sql){
+  size_t end = sql.size();
+  while(end > 0 && (sql[end - 1] == ';' || std::isspace(static_cast<unsigned char>(sql[end - 1])))){
+    end--;
+  }
+  return sql.substr(0, end);
+};
+
+std::string first_keyword(const std::string& sql){
+  size_t i = 0;
+  while(i < sql.size() && (std::isspace(static_cast<unsigned char>(sql[i])) || sql[i] == '(')){ i++; }
+  std::string out;
+  while(i < sql.size() && std::isalpha(static_cast<unsigned char>(sql[i]))){
+    out.push_back(std::toupper(static_cast<unsigned char>(sql[i])));
+    i++;
+  }
+  return out;
+};
+
+// Reads the token at `i` into `out`: a word (upper-cased), a string
+// literal or a quoted identifier (both unquoted). Returns 'w', '\'' or
+// '"' for these, ';' for the end of the statement and 0 otherwise.
+static char next_token(const std::string& sql, size_t& i, std::string& out){
+  out.clear();
+  while(i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))){ i++; }
+  if(i == sql.size() || sql[i] == ';'){
+    return ';';
+  }
+  char ch = sql[i];
+  if(ch == '\'' || ch == '"'){
+    i++;
+    while(i < sql.size()){
+      if(sql[i] == ch){
+        // A doubled quote stands for itself.
+        if(i + 1 < sql.size() && sql[i + 1] == ch){
+          out.push_back(ch);
+          i += 2;
+          continue;
+        }
+        i++;
+        return ch;
+      }
+      out.push_back(sql[i++]);
+    }
+    return 0;
+  }
+  while(i < sql.size() && (std::isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '_')){
+    out.push_back(std::toupper(static_cast<unsigned char>(sql[i])));
+    i++;
+  }
+  return out.empty() ? 0 : 'w';
+}
+
+// Skips an optional DATABASE after the leading keyword.
+static char database_target(const std::string& sql, const std::string& keyword, size_t& i, std::string& out){
+  if(next_token(sql, i, out) != 'w' || out != keyword){
+    return 0;
+  }
+  char kind = next_token(sql, i, out);
+  if(kind == 'w' && out == "DATABASE"){
+    kind = next_token(sql, i, out);
+  }
+  return kind;
+}
+
+// Unquoted names fold to lower case.
+static std::string unquoted_name(const std::string& word){
+  std::string out = word;
+  for(char& c: out){ c = std::tolower(static_cast<unsigned char>(c)); }
+  return out;
+}
+
+bool parse_attach(const std::string& sql, std::string& path, std::string& alias){
+  size_t i = 0;
+  std::string token;
+  if(database_target(sql, "ATTACH", i, token) != '\''){
+    return false;
+  }
+  path = token;
+  char kind = next_token(sql, i, token);
+  if(kind == ';'){
+    size_t slash = path.find_last_of("/\\");
+    std::string file = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = file.find_last_of('.');
+    alias = (dot == std::string::npos || dot == 0) ? file : file.substr(0, dot);
+    return true;
+  }
+  if(kind != 'w' || token != "AS"){
+    return false;
+  }
+  kind = next_token(sql, i, token);
+  if(kind == '"'){
+    alias = token;
+  }else if(kind == 'w'){
+    alias = unquoted_name(token);
+  }else{
+    return false;
+  }
+  return next_token(sql, i, token) == ';';
+};
+
+bool parse_detach(const std::string& sql, std::string& alias){
+  size_t i = 0;
+  std::string token;
+  char kind = database_target(sql, "DETACH", i, token);
+  if(kind == '"'){
+    alias = token;
+  }else if(kind == 'w'){
+    alias = unquoted_name(token);
+  }else{
+    return false;
+  }
+  return next_token(sql, i, token) == ';';
+};
+
+void statement_cache::evict_to(size_t n){
+  while(entries.size() > n){
+    evicted.push_back(entries.back().name);
+    index.erase(entries.back().key);
+    entries.pop_back();
+  }
+};
+
+std::string statement_cache::prepare(hyperapi::Connection& c, const std::string& key, const std::string& sql){
+  auto hit = index.find(key);
+  if(hit != index.end()){
+    entries.splice(entries.begin(), entries, hit->second);
+    return hit->second->name;
+  }
+  deallocate_evicted(c);
+  std::string name = "rhyper_stmt_" + std::to_string(++counter);
+  hyperapi::internal::prepareQuery(c, name, sql);
+  if(capacity == 0){
+    // Nothing is kept; the statement goes with the next cleanup.
+    evicted.push_back(name);
+    return name;
+  }
+  entries.push_front({key, name});
+  index[key] = entries.begin();
+  evict_to(capacity);
+  return name;
+};
+
+void statement_cache::forget(const std::string& key){
+  auto hit = index.find(key);
+  if(hit == index.end()){ return; }
+  evicted.push_back(hit->second->name);
+  entries.erase(hit->second);
+  index.erase(hit);
+};
+
+void statement_cache::deallocate_evicted(hyperapi::Connection& c){
+  if(evicted.empty() || !c.isOpen() || !c.isReady()){ return; }
+  for(const auto& name: evicted){
+    try{
+      c.executeCommand("DEALLOCATE " + hyperapi::escapeName(name));
+    }
+    catch(...){
+      // Already gone (e.g. after a failed execution); nothing to free.
+    }
+  }
+  evicted.clear();
+};
+
+void statement_cache::clear(hyperapi::Connection& c){
+  evict_to(0);
+  deallocate_evicted(c);
+  evicted.clear();
+};
+
+void statement_cache::resize(size_t n){
+  capacity = n;
+  evict_to(capacity);
+};
+
+}
@@ -0,0 +1,61 @@
+
+#ifndef __RHYPER_STATEMENTS__
+#define __RHYPER_STATEMENTS__
+
+#include "hyperapi/hyperapi.hpp"
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace RHyper {
+
+std::string normalize_sql(const std::string& sql);
+std::string strip_terminator(const std::string& sql);
+// The statement's leading keyword, upper-cased (e.g. "SELECT").
+std::string first_keyword(const std::string& sql);
+// For `ATTACH [DATABASE] 'path' [AS alias]`: the path and the alias,
+// which defaults to the file's stem. False for any other statement.
+bool parse_attach(const std::string& sql, std::string& path, std::string& alias);
+// For `DETACH [DATABASE] alias`.
+bool parse_detach(const std::string& sql, std::string& alias);
+
+/*
+ * Prepared statements of one connection, least recently used first
+ * out. Statements are keyed by their normalized SQL text (see
+ * normalize_sql), prepared from the text as given and named
+ * rhyper_stmt_<n> on the server. Evicted statements are deallocated
+ * the next time the connection is ready, since DEALLOCATE cannot run
+ * while a rowset is open.
+ */
+class statement_cache {
+private:
+  struct entry {
+    std::string key;
+    std::string name;
+  };
+  size_t capacity;
+  uint64_t counter = 0;
+  std::list<entry> entries;
+  std::unordered_map<std::string, std::list<entry>::iterator> index;
+  std::vector<std::string> evicted;
+  void evict_to(size_t n);
+public:
+  statement_cache(statement_cache const &)=delete;
+  statement_cache &operator=(statement_cache const &)=delete;
+  statement_cache(size_t n = 64): capacity(n) {};
+  // Prepares `sql` unless `key` is cached; returns the statement name.
+  std::string prepare(hyperapi::Connection& c, const std::string& key, const std::string& sql);
+  bool contains(const std::string& key){ return index.count(key) > 0; };
+  void forget(const std::string& key);
+  void deallocate_evicted(hyperapi::Connection& c);
+  void clear(hyperapi::Connection& c);
+  void resize(size_t n);
+  size_t size(){ return entries.size(); };
+  size_t get_capacity(){ return capacity; };
+};
+
+}
+
+#endif